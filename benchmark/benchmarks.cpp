@@ -0,0 +1,348 @@
+/**
+ * Microbenchmarks of the hot paths of the branching schemes of the examples.
+ *
+ * For each scheme, the following operations are measured on synthetic
+ * instances of several sizes built with the seeded instance generators of the
+ * examples:
+ * - 'root'
+ * - expansion of a node with 'next_child' or 'children'
+ * - hash and equality of the 'NodeHasher'
+ * - 'dominates'
+ * - insertion and removal in a 'NodeSet'
+ */
+
+#include "treesearchsolver/common.hpp"
+#include "treesearchsolver/examples/knapsack_with_conflicts.hpp"
+#include "treesearchsolver/examples/sequential_ordering.hpp"
+#include "treesearchsolver/examples/permutation_flowshop_scheduling_makespan.hpp"
+#include "treesearchsolver/examples/permutation_flowshop_scheduling_tct.hpp"
+#include "treesearchsolver/examples/simple_assembly_line_balancing_1.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <list>
+#include <random>
+
+using namespace treesearchsolver;
+
+namespace
+{
+
+/** Maximum number of nodes sampled for the node benchmarks. */
+const std::size_t maximum_number_of_sampled_nodes = 1024;
+
+/** Maximum number of nodes kept at each depth when sampling. */
+const std::size_t maximum_width = 32;
+
+template <typename BranchingScheme>
+using ExpandFunction = std::vector<std::shared_ptr<typename BranchingScheme::Node>> (*)(
+        const BranchingScheme&,
+        const std::shared_ptr<typename BranchingScheme::Node>&);
+
+/**
+ * Expand a node with 'next_child'.
+ *
+ * The node is copied so that the sampled nodes are never modified.
+ */
+template <typename BranchingScheme>
+std::vector<std::shared_ptr<typename BranchingScheme::Node>> expand_next_child(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<typename BranchingScheme::Node>& node)
+{
+    using Node = typename BranchingScheme::Node;
+    std::shared_ptr<Node> parent = std::shared_ptr<Node>(new Node(*node));
+    std::vector<std::shared_ptr<Node>> children;
+    while (!branching_scheme.infertile(parent)) {
+        std::shared_ptr<Node> child = branching_scheme.next_child(parent);
+        if (child != nullptr)
+            children.push_back(child);
+    }
+    return children;
+}
+
+/**
+ * Expand a node with 'children'.
+ */
+template <typename BranchingScheme>
+std::vector<std::shared_ptr<typename BranchingScheme::Node>> expand_children(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<typename BranchingScheme::Node>& node)
+{
+    return branching_scheme.children(node);
+}
+
+/**
+ * Sample nodes at every depth of the tree.
+ *
+ * At each depth, at most 'maximum_width' nodes, chosen randomly with a fixed
+ * seed, are expanded.
+ */
+template <typename BranchingScheme>
+std::vector<std::shared_ptr<typename BranchingScheme::Node>> sample_nodes(
+        const BranchingScheme& branching_scheme,
+        ExpandFunction<BranchingScheme> expand)
+{
+    using Node = typename BranchingScheme::Node;
+    std::mt19937_64 generator(0);
+    std::vector<std::shared_ptr<Node>> nodes;
+    std::vector<std::shared_ptr<Node>> current_nodes = {branching_scheme.root()};
+    while (!current_nodes.empty()
+            && nodes.size() < maximum_number_of_sampled_nodes) {
+        std::vector<std::shared_ptr<Node>> next_nodes;
+        for (const std::shared_ptr<Node>& node: current_nodes) {
+            for (const std::shared_ptr<Node>& child: expand(branching_scheme, node)) {
+                if (branching_scheme.leaf(child))
+                    continue;
+                next_nodes.push_back(child);
+            }
+        }
+        std::shuffle(next_nodes.begin(), next_nodes.end(), generator);
+        if (next_nodes.size() > maximum_width)
+            next_nodes.resize(maximum_width);
+        for (const std::shared_ptr<Node>& node: next_nodes)
+            if (nodes.size() < maximum_number_of_sampled_nodes)
+                nodes.push_back(node);
+        current_nodes.swap(next_nodes);
+    }
+    return nodes;
+}
+
+template <typename BranchingScheme>
+void register_node_set_benchmark(
+        const std::string& name,
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<std::vector<std::shared_ptr<typename BranchingScheme::Node>>>& nodes)
+{
+    using Node = typename BranchingScheme::Node;
+    benchmark::RegisterBenchmark(
+            (name + "/node_set").c_str(),
+            [&branching_scheme, nodes](benchmark::State& state)
+            {
+                for (auto _: state) {
+                    NodeSet<BranchingScheme> q(branching_scheme);
+                    for (const std::shared_ptr<Node>& node: *nodes)
+                        q.insert(node);
+                    for (const std::shared_ptr<Node>& node: *nodes)
+                        q.erase(node);
+                }
+                state.SetItemsProcessed(2 * state.iterations() * nodes->size());
+            });
+}
+
+template <typename BranchingScheme>
+void register_benchmarks(
+        const std::string& name,
+        const BranchingScheme& branching_scheme,
+        ExpandFunction<BranchingScheme> expand)
+{
+    using Node = typename BranchingScheme::Node;
+    typedef std::vector<std::shared_ptr<Node>> Nodes;
+    typedef std::vector<std::pair<std::shared_ptr<Node>, std::shared_ptr<Node>>> NodePairs;
+
+    std::shared_ptr<Nodes> nodes(new Nodes(sample_nodes(branching_scheme, expand)));
+
+    // Comparable nodes, pairs of comparable nodes, and pairs of comparable
+    // nodes with the same state. If the scheme has no comparable nodes, all
+    // sampled nodes are used so that the hasher is still measured.
+    std::shared_ptr<Nodes> comparable_nodes(new Nodes());
+    for (const std::shared_ptr<Node>& node: *nodes)
+        if (branching_scheme.comparable(node))
+            comparable_nodes->push_back(node);
+    if (comparable_nodes->empty())
+        *comparable_nodes = *nodes;
+    std::shared_ptr<NodePairs> pairs(new NodePairs());
+    for (std::size_t pos = 0; pos < comparable_nodes->size(); ++pos) {
+        pairs->push_back({
+                (*comparable_nodes)[pos],
+                (*comparable_nodes)[(7 * pos + 1) % comparable_nodes->size()]});
+    }
+    auto node_hasher = branching_scheme.node_hasher();
+    NodeMap<BranchingScheme> history{0, node_hasher, node_hasher};
+    for (const std::shared_ptr<Node>& node: *comparable_nodes)
+        history[node].push_back(node);
+    std::shared_ptr<NodePairs> same_state_pairs(new NodePairs());
+    for (const auto& p: history)
+        for (const std::shared_ptr<Node>& node_1: p.second)
+            for (const std::shared_ptr<Node>& node_2: p.second)
+                same_state_pairs->push_back({node_1, node_2});
+
+    benchmark::RegisterBenchmark(
+            (name + "/root").c_str(),
+            [&branching_scheme](benchmark::State& state)
+            {
+                for (auto _: state)
+                    benchmark::DoNotOptimize(branching_scheme.root());
+            });
+
+    if (nodes->empty())
+        return;
+
+    benchmark::RegisterBenchmark(
+            (name + "/expand").c_str(),
+            [&branching_scheme, expand, nodes](benchmark::State& state)
+            {
+                std::size_t pos = 0;
+                int64_t number_of_children = 0;
+                for (auto _: state) {
+                    auto children = expand(branching_scheme, (*nodes)[pos]);
+                    number_of_children += children.size();
+                    benchmark::DoNotOptimize(children.data());
+                    pos = (pos + 1) % nodes->size();
+                }
+                state.SetItemsProcessed(number_of_children);
+            });
+
+    register_node_set_benchmark(name, branching_scheme, nodes);
+
+    benchmark::RegisterBenchmark(
+            (name + "/hash").c_str(),
+            [&branching_scheme, comparable_nodes](benchmark::State& state)
+            {
+                auto node_hasher = branching_scheme.node_hasher();
+                std::size_t pos = 0;
+                for (auto _: state) {
+                    benchmark::DoNotOptimize(node_hasher((*comparable_nodes)[pos]));
+                    pos = (pos + 1) % comparable_nodes->size();
+                }
+                state.SetItemsProcessed(state.iterations());
+            });
+
+    benchmark::RegisterBenchmark(
+            (name + "/equals").c_str(),
+            [&branching_scheme, pairs](benchmark::State& state)
+            {
+                auto node_hasher = branching_scheme.node_hasher();
+                std::size_t pos = 0;
+                for (auto _: state) {
+                    benchmark::DoNotOptimize(node_hasher(
+                                (*pairs)[pos].first,
+                                (*pairs)[pos].second));
+                    pos = (pos + 1) % pairs->size();
+                }
+                state.SetItemsProcessed(state.iterations());
+            });
+
+    benchmark::RegisterBenchmark(
+            (name + "/dominates").c_str(),
+            [&branching_scheme, same_state_pairs](benchmark::State& state)
+            {
+                std::size_t pos = 0;
+                for (auto _: state) {
+                    benchmark::DoNotOptimize(branching_scheme.dominates(
+                                (*same_state_pairs)[pos].first,
+                                (*same_state_pairs)[pos].second));
+                    pos = (pos + 1) % same_state_pairs->size();
+                }
+                state.SetItemsProcessed(state.iterations());
+            });
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    // Instances and branching schemes are stored in lists so that they
+    // outlive the benchmarks and are never moved.
+
+    std::list<knapsack_with_conflicts::Instance> knapsack_with_conflicts_instances;
+    std::list<knapsack_with_conflicts::BranchingScheme> knapsack_with_conflicts_branching_schemes;
+    for (knapsack_with_conflicts::ItemId number_of_items: {100, 1000}) {
+        knapsack_with_conflicts_instances.push_back(
+                knapsack_with_conflicts::generate_instance(number_of_items, 0.05));
+        knapsack_with_conflicts_branching_schemes.emplace_back(
+                knapsack_with_conflicts_instances.back(),
+                knapsack_with_conflicts::BranchingScheme::Parameters());
+        register_benchmarks(
+                "knapsack_with_conflicts/" + std::to_string(number_of_items),
+                knapsack_with_conflicts_branching_schemes.back(),
+                &expand_next_child<knapsack_with_conflicts::BranchingScheme>);
+    }
+
+    std::list<sequential_ordering::Instance> sequential_ordering_instances;
+    std::list<sequential_ordering::BranchingScheme> sequential_ordering_branching_schemes;
+    for (sequential_ordering::LocationId number_of_locations: {100, 500}) {
+        sequential_ordering_instances.push_back(
+                sequential_ordering::generate_instance(number_of_locations, 0.02));
+        sequential_ordering_branching_schemes.emplace_back(
+                sequential_ordering_instances.back(),
+                sequential_ordering::BranchingScheme::Parameters());
+        register_benchmarks(
+                "sequential_ordering/" + std::to_string(number_of_locations),
+                sequential_ordering_branching_schemes.back(),
+                &expand_next_child<sequential_ordering::BranchingScheme>);
+    }
+
+    // Number of jobs, number of machines, and seed.
+    std::vector<std::pair<std::pair<int64_t, int64_t>, int64_t>> flowshop_sizes = {
+        {{50, 10}, 1958948863},
+        {{200, 20}, 471503978}};
+
+    std::list<permutation_flowshop_scheduling_makespan::Instance> permutation_flowshop_scheduling_makespan_instances;
+    std::list<permutation_flowshop_scheduling_makespan::BranchingSchemeBidirectional> permutation_flowshop_scheduling_makespan_branching_schemes;
+    for (const auto& size: flowshop_sizes) {
+        permutation_flowshop_scheduling_makespan_instances.push_back(
+                permutation_flowshop_scheduling_makespan::generate_instance(
+                    size.first.first,
+                    size.first.second,
+                    size.second));
+        permutation_flowshop_scheduling_makespan_branching_schemes.emplace_back(
+                permutation_flowshop_scheduling_makespan_instances.back(),
+                permutation_flowshop_scheduling_makespan::BranchingSchemeBidirectional::Parameters());
+        register_benchmarks(
+                "permutation_flowshop_scheduling_makespan/"
+                + std::to_string(size.first.first) + "x" + std::to_string(size.first.second),
+                permutation_flowshop_scheduling_makespan_branching_schemes.back(),
+                &expand_next_child<permutation_flowshop_scheduling_makespan::BranchingSchemeBidirectional>);
+    }
+
+    std::list<permutation_flowshop_scheduling_tct::Instance> permutation_flowshop_scheduling_tct_instances;
+    std::list<permutation_flowshop_scheduling_tct::BranchingScheme> permutation_flowshop_scheduling_tct_branching_schemes;
+    for (const auto& size: flowshop_sizes) {
+        permutation_flowshop_scheduling_tct_instances.push_back(
+                permutation_flowshop_scheduling_tct::generate_instance(
+                    size.first.first,
+                    size.first.second,
+                    size.second));
+        permutation_flowshop_scheduling_tct_branching_schemes.emplace_back(
+                permutation_flowshop_scheduling_tct_instances.back(),
+                permutation_flowshop_scheduling_tct::BranchingScheme::Parameters());
+        register_benchmarks(
+                "permutation_flowshop_scheduling_tct/"
+                + std::to_string(size.first.first) + "x" + std::to_string(size.first.second),
+                permutation_flowshop_scheduling_tct_branching_schemes.back(),
+                &expand_next_child<permutation_flowshop_scheduling_tct::BranchingScheme>);
+    }
+
+    std::list<simple_assembly_line_balancing_1::Instance> simple_assembly_line_balancing_1_instances;
+    std::list<simple_assembly_line_balancing_1::BranchingScheme> simple_assembly_line_balancing_1_branching_schemes;
+    for (simple_assembly_line_balancing_1::JobId number_of_jobs: {50, 1000}) {
+        simple_assembly_line_balancing_1_instances.push_back(
+                simple_assembly_line_balancing_1::generate_instance(number_of_jobs, 0.6));
+        simple_assembly_line_balancing_1_branching_schemes.emplace_back(
+                simple_assembly_line_balancing_1_instances.back());
+        register_benchmarks(
+                "simple_assembly_line_balancing_1/" + std::to_string(number_of_jobs),
+                simple_assembly_line_balancing_1_branching_schemes.back(),
+                &expand_children<simple_assembly_line_balancing_1::BranchingScheme>);
+    }
+
+    std::list<simple_assembly_line_balancing_1::BranchingSchemeStation> simple_assembly_line_balancing_1_station_branching_schemes;
+    for (const simple_assembly_line_balancing_1::Instance& instance: simple_assembly_line_balancing_1_instances) {
+        simple_assembly_line_balancing_1::BranchingSchemeStation::Parameters parameters;
+        parameters.maximum_number_of_loads = 1000;
+        simple_assembly_line_balancing_1_station_branching_schemes.emplace_back(
+                instance,
+                parameters);
+        register_benchmarks(
+                "simple_assembly_line_balancing_1_station/" + std::to_string(instance.number_of_jobs()),
+                simple_assembly_line_balancing_1_station_branching_schemes.back(),
+                &expand_children<simple_assembly_line_balancing_1::BranchingSchemeStation>);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "treesearchsolver/common.hpp"
+#include "treesearchsolver/event_writer.hpp"
+#include "treesearchsolver/trace_writer.hpp"
 
 #include <sstream>
 #include <iomanip>
@@ -24,7 +26,11 @@ public:
         branching_scheme_(branching_scheme),
         parameters_(parameters),
         output_(output),
-        os_(parameters.create_os()) { }
+        os_(parameters.create_os()),
+        cancellation_token_(
+                (parameters.cancellation_token != nullptr)?
+                parameters.cancellation_token:
+                std::shared_ptr<CancellationToken>(new CancellationToken())) { }
 
     /** Print the header. */
     void start(
@@ -41,6 +47,35 @@ public:
     void update_solution(
             const std::shared_ptr<Node>& node);
 
+    /**
+     * Return 'true' iff the algorithm needs to end.
+     *
+     * This only reads the cancellation token, set by the caller or once the
+     * timer needs to end.
+     */
+    inline bool needs_to_end() const { return cancellation_token_->cancelled(); }
+
+    /** Update the counters read by the telemetry reporter. */
+    inline void update_telemetry(
+            NodeId number_of_nodes,
+            NodeId queue_size,
+            NodeId history_number_of_keys)
+    {
+        if (telemetry_reporter_ == nullptr)
+            return;
+        telemetry_reporter_->update(
+                number_of_nodes,
+                queue_size,
+                history_number_of_keys);
+    }
+
+    /** Start a span of the trace (iteration, restart...). */
+    void start_span(
+            const std::string& name);
+
+    /** End the last started span of the trace. */
+    void end_span();
+
     /** Method to call at the end of the algorithm. */
     void end();
 
@@ -263,6 +298,27 @@ private:
     /** Output stream. */
     std::unique_ptr<optimizationtools::ComposeStream> os_;
 
+    /** Trace writer. */
+    std::unique_ptr<TraceWriter> trace_writer_;
+
+    /** Event writer. */
+    std::unique_ptr<EventWriter> event_writer_;
+
+    /** Names of the spans started and not ended yet. */
+    std::vector<std::string> open_spans_;
+
+    /** Telemetry reporter. */
+    std::unique_ptr<TelemetryReporter> telemetry_reporter_;
+
+    /** Cancellation token. */
+    std::shared_ptr<CancellationToken> cancellation_token_;
+
+    /** Deadline watcher. */
+    std::unique_ptr<DeadlineWatcher> deadline_watcher_;
+
+    /** Times and values of the successive improving solutions. */
+    std::vector<std::pair<double, Value>> solutions_;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -275,6 +331,43 @@ void AlgorithmFormatter<BranchingScheme>::start(
 {
     output_.json["Parameters"] = parameters_.to_json();
 
+    deadline_watcher_ = std::unique_ptr<DeadlineWatcher>(
+            new DeadlineWatcher(
+                parameters_.timer,
+                *cancellation_token_,
+                parameters_.deadline_check_period));
+    set_cancellation_token(branching_scheme_, cancellation_token_);
+    deadline_watcher_->start();
+
+    if (!parameters_.trace_path.empty()) {
+        trace_writer_ = std::unique_ptr<TraceWriter>(
+                new TraceWriter(parameters_.trace_path));
+        trace_writer_->begin(
+                algorithm_name,
+                parameters_.timer.elapsed_time());
+    }
+
+    if (!parameters_.events_path.empty()) {
+        event_writer_ = std::unique_ptr<EventWriter>(
+                new EventWriter(parameters_.events_path));
+        event_writer_->write(
+                "Start",
+                parameters_.timer.elapsed_time(),
+                {{"Algorithm", algorithm_name},
+                 {"Parameters", output_.json["Parameters"]}});
+    }
+
+    if (!parameters_.telemetry_path.empty()) {
+        telemetry_reporter_ = std::unique_ptr<TelemetryReporter>(
+                new TelemetryReporter(
+                    algorithm_name,
+                    parameters_.telemetry_path,
+                    parameters_.telemetry_format,
+                    parameters_.telemetry_period,
+                    sizeof(Node)));
+        telemetry_reporter_->start();
+    }
+
     if (parameters_.verbosity_level == 0)
         return;
     *os_
@@ -332,16 +425,88 @@ void AlgorithmFormatter<BranchingScheme>::update_solution(
         const std::shared_ptr<Node>& node)
 {
     if (output_.solution_pool.add(node) == 2) {
+        output_.time = parameters_.timer.elapsed_time();
         output_.json["IntermediaryOutputs"].push_back(output_.to_json());
+        Value node_value = value(branching_scheme_, node);
+        if (!std::isnan(node_value))
+            solutions_.push_back({output_.time, node_value});
+        if (telemetry_reporter_ != nullptr) {
+            telemetry_reporter_->counters().best_value.store(
+                    node_value,
+                    std::memory_order_relaxed);
+        }
+        if (trace_writer_ != nullptr) {
+            trace_writer_->instant(
+                    "Solution",
+                    parameters_.timer.elapsed_time(),
+                    {{"Value", branching_scheme_.display(node)}});
+        }
+        if (event_writer_ != nullptr) {
+            event_writer_->write(
+                    "Solution",
+                    output_.time,
+                    {{"Output", output_.json["IntermediaryOutputs"].back()}});
+        }
         parameters_.new_solution_callback(output_);
     }
 }
 
+template <typename BranchingScheme>
+void AlgorithmFormatter<BranchingScheme>::start_span(
+        const std::string& name)
+{
+    if (event_writer_ != nullptr)
+        open_spans_.push_back(name);
+    if (trace_writer_ != nullptr)
+        trace_writer_->begin(name, parameters_.timer.elapsed_time());
+}
+
+template <typename BranchingScheme>
+void AlgorithmFormatter<BranchingScheme>::end_span()
+{
+    if (event_writer_ != nullptr && !open_spans_.empty()) {
+        event_writer_->write(
+                "Iteration",
+                parameters_.timer.elapsed_time(),
+                {{"Name", open_spans_.back()},
+                 {"Value", branching_scheme_.display(output_.solution_pool.best())}});
+        open_spans_.pop_back();
+    }
+    if (trace_writer_ != nullptr) {
+        trace_writer_->end(
+                parameters_.timer.elapsed_time(),
+                {{"Value", branching_scheme_.display(output_.solution_pool.best())}});
+    }
+}
+
 template <typename BranchingScheme>
 void AlgorithmFormatter<BranchingScheme>::end()
 {
+    output_.stop_latency = cancellation_token_->time_since_cancellation();
+    deadline_watcher_->stop();
+    set_cancellation_token(branching_scheme_, nullptr);
     output_.time = parameters_.timer.elapsed_time();
+    output_.anytime_profile = compute_anytime_profile(
+            solutions_,
+            output_.time,
+            parameters_.reference_value,
+            parameters_.target_gap);
     output_.json["Output"] = output_.to_json();
+    if (output_.history_statistics.number_of_lookups > 0)
+        output_.json["Output"]["HistoryStatistics"] = output_.history_statistics.to_json();
+
+    if (trace_writer_ != nullptr) {
+        // Close the spans left open when the algorithm stopped early.
+        while (trace_writer_->number_of_open_spans() > 0)
+            trace_writer_->end(output_.time);
+        trace_writer_->write();
+    }
+
+    if (event_writer_ != nullptr)
+        event_writer_->write("End", output_.time, {{"Output", output_.json["Output"]}});
+
+    if (telemetry_reporter_ != nullptr)
+        telemetry_reporter_->stop();
 
     if (parameters_.verbosity_level == 0)
         return;
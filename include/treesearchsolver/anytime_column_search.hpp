@@ -103,12 +103,16 @@ inline const AnytimeColumnSearchOutput<BranchingScheme> anytime_column_search(
     algorithm_formatter.start("Anytime column search");
     algorithm_formatter.print_header();
 
+    ChildGenerator<BranchingScheme> child_generator(branching_scheme);
+
     // Initialize q and history.
     auto node_hasher = branching_scheme.node_hasher();
     std::vector<NodeSet<BranchingScheme>> q
         = {NodeSet<BranchingScheme>(branching_scheme)};
     std::vector<NodeMap<BranchingScheme>> history
         = {NodeMap<BranchingScheme>(0, node_hasher, node_hasher)};
+    HistoryStatistics* history_statistics = (parameters.history_statistics)?
+        &output.history_statistics: nullptr;
     q[0].insert(branching_scheme.root());
 
     double maximum_number_of_children = parameters.initial_column_size;
@@ -123,6 +127,7 @@ inline const AnytimeColumnSearchOutput<BranchingScheme> anytime_column_search(
         std::stringstream ss;
         ss << "iteration " << output.number_of_iterations;
         algorithm_formatter.print(ss);
+        algorithm_formatter.start_span(ss.str());
 
         NodeId number_of_nodes_back = output.number_of_nodes;
         for (Counter current_depth = 0; current_depth < (Counter)q.size(); ++current_depth) {
@@ -140,20 +145,25 @@ inline const AnytimeColumnSearchOutput<BranchingScheme> anytime_column_search(
 
                     // Bound.
                     if (branching_scheme.bound(current_node, output.solution_pool.worst())) {
+                        child_generator.release(current_node);
                         current_node = nullptr;
                         continue;
                     }
                 }
 
                 // Get next child.
-                auto child = branching_scheme.next_child(current_node);
+                auto child = child_generator.next_child(current_node);
 
                 if (child != nullptr) {
 
                     output.number_of_nodes++;
+                    algorithm_formatter.update_telemetry(
+                            output.number_of_nodes,
+                            q[current_depth].size(),
+                            history[current_depth].size());
 
                     // Check time.
-                    if (parameters.timer.needs_to_end())
+                    if (algorithm_formatter.needs_to_end())
                         goto acsend;
 
                     // Check node limit.
@@ -192,12 +202,14 @@ inline const AnytimeColumnSearchOutput<BranchingScheme> anytime_column_search(
                                 branching_scheme,
                                 history[child_depth],
                                 q[child_depth],
-                                child);
+                                child,
+                                history_statistics,
+                                &child_generator);
                     }
                 }
 
                 // If current_node still has children, put it back to the queue.
-                if (branching_scheme.infertile(current_node)) {
+                if (child_generator.infertile(current_node)) {
                     current_node = nullptr;
                 } else if (!q[current_depth].empty()
                         && branching_scheme(*(q[current_depth].begin()), current_node)) {
@@ -216,6 +228,8 @@ inline const AnytimeColumnSearchOutput<BranchingScheme> anytime_column_search(
 
         }
 
+        algorithm_formatter.end_span();
+
         if (output.number_of_nodes == number_of_nodes_back) {
             break;
         }
@@ -81,17 +81,25 @@ inline const BestFirstSearchOutput<BranchingScheme> best_first_search(
     algorithm_formatter.start("Best first search");
     algorithm_formatter.print_header();
 
+    ChildGenerator<BranchingScheme> child_generator(branching_scheme);
+
     auto node_hasher = branching_scheme.node_hasher();
     NodeMap<BranchingScheme> history{0, node_hasher, node_hasher};
+    HistoryStatistics* history_statistics = (parameters.history_statistics)?
+        &output.history_statistics: nullptr;
     NodeSet<BranchingScheme> q(branching_scheme);
 
     auto current_node = branching_scheme.root();
 
     while (current_node != nullptr || !q.empty()) {
         output.number_of_nodes++;
+        algorithm_formatter.update_telemetry(
+                output.number_of_nodes,
+                q.size(),
+                history.size());
 
         // Check time.
-        if (parameters.timer.needs_to_end())
+        if (algorithm_formatter.needs_to_end())
             break;
 
         // Check node limit.
@@ -119,12 +127,13 @@ inline const BestFirstSearchOutput<BranchingScheme> best_first_search(
 
         // Bound.
         if (branching_scheme.bound(current_node, output.solution_pool.worst())) {
+            child_generator.release(current_node);
             current_node = nullptr;
             continue;
         }
 
         // Get next child.
-        auto child = branching_scheme.next_child(current_node);
+        auto child = child_generator.next_child(current_node);
         // Bound.
         if (child != nullptr) {
             // Update best solution.
@@ -137,11 +146,11 @@ inline const BestFirstSearchOutput<BranchingScheme> best_first_search(
             // Add child to the queue.
             if (!branching_scheme.leaf(child)
                     && !branching_scheme.bound(child, output.solution_pool.worst()))
-                add_to_history_and_queue(branching_scheme, history, q, child);
+                add_to_history_and_queue(branching_scheme, history, q, child, history_statistics, &child_generator);
         }
 
         // If current_node still has children, put it back to the queue.
-        if (branching_scheme.infertile(current_node)) {
+        if (child_generator.infertile(current_node)) {
             current_node = nullptr;
         } else if ((Counter)q.size() != 0
                 && branching_scheme(*(q.begin()), current_node)) {
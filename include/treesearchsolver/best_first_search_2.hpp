@@ -83,6 +83,8 @@ inline const BestFirstSearch2Output<BranchingScheme> best_first_search_2(
 
     auto node_hasher = branching_scheme.node_hasher();
     NodeMap<BranchingScheme> history{0, node_hasher, node_hasher};
+    HistoryStatistics* history_statistics = (parameters.history_statistics)?
+        &output.history_statistics: nullptr;
     NodeSet<BranchingScheme> q(branching_scheme);
 
     // Add root node to the queue.
@@ -91,7 +93,7 @@ inline const BestFirstSearch2Output<BranchingScheme> best_first_search_2(
     while (!q.empty()) {
 
         // Check time.
-        if (parameters.timer.needs_to_end())
+        if (algorithm_formatter.needs_to_end())
             break;
 
         // Check node limit.
@@ -113,6 +115,10 @@ inline const BestFirstSearch2Output<BranchingScheme> best_first_search_2(
         q.erase(q.begin());
 
         output.number_of_nodes++;
+        algorithm_formatter.update_telemetry(
+                output.number_of_nodes,
+                q.size(),
+                history.size());
 
         if (output.number_of_nodes % 1000000 == 0)
             std::cout << branching_scheme.display(current_node) << std::endl;
@@ -124,7 +130,7 @@ inline const BestFirstSearch2Output<BranchingScheme> best_first_search_2(
         }
 
         // Get next child.
-        auto children = branching_scheme.children(current_node);
+        auto children = generate_children(branching_scheme, current_node);
 
         for (auto child: children) {
             // Update best solution.
@@ -138,7 +144,7 @@ inline const BestFirstSearch2Output<BranchingScheme> best_first_search_2(
             // Add child to the queue.
             if (!branching_scheme.leaf(child)
                     && !branching_scheme.bound(child, output.solution_pool.worst())) {
-                add_to_history_and_queue(branching_scheme, history, q, child);
+                add_to_history_and_queue(branching_scheme, history, q, child, history_statistics);
             }
         }
     }
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "optimizationtools/utils/output.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace treesearchsolver
+{
+
+/**
+ * Flag telling an algorithm to stop.
+ *
+ * It may be set from any thread, for example by a service embedding the
+ * solver, and the algorithms poll it with a single relaxed load.
+ *
+ * A token can't be reset: once cancelled, it stays cancelled, and an
+ * algorithm given a cancelled token stops at once. A new token is needed for
+ * each solve.
+ */
+class CancellationToken
+{
+
+public:
+
+    /** Constructor. */
+    CancellationToken() { }
+
+    /** Request the algorithm to stop. */
+    inline void cancel() { cancel(std::chrono::steady_clock::now()); }
+
+    /**
+     * Request the algorithm to stop, with the time from which the stop
+     * latency is measured.
+     */
+    inline void cancel(
+            std::chrono::steady_clock::time_point cancellation_time)
+    {
+        if (cancelled_.load(std::memory_order_relaxed))
+            return;
+        cancellation_time_.store(
+                cancellation_time.time_since_epoch().count(),
+                std::memory_order_relaxed);
+        cancelled_.store(true, std::memory_order_release);
+    }
+
+    /** Return 'true' iff the algorithm has been requested to stop. */
+    inline bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+    /**
+     * Get the time elapsed since the cancellation in seconds.
+     *
+     * Return NaN if the token hasn't been cancelled.
+     */
+    double time_since_cancellation() const;
+
+private:
+
+    /** True if the algorithm has been requested to stop. */
+    std::atomic<bool> cancelled_{false};
+
+    /** Time of the cancellation, in ticks of the steady clock. */
+    std::atomic<int64_t> cancellation_time_{0};
+
+};
+
+/**
+ * Install a SIGINT handler which cancels the tokens of the running
+ * algorithms.
+ *
+ * The handler cancels the tokens directly, with stores to lock-free atomics
+ * which are async-signal-safe, so the algorithms stop at their next poll and
+ * their stop latency is measured from the signal. Algorithms started after
+ * the signal are cancelled at once. A second SIGINT terminates the process.
+ *
+ * Signal handlers are process-wide: this should be called once, before
+ * starting the threads running the algorithms.
+ */
+void set_sigint_handler();
+
+/**
+ * Class that cancels a token once a timer needs to end.
+ *
+ * The watcher thread sleeps until the time limit of the timer, so that the
+ * search thread doesn't read the clock at each node. While it runs, the token
+ * is also cancelled by the handler of 'set_sigint_handler'. The other reasons
+ * for the timer to end, such as its own SIGINT handler, can't be waited for;
+ * they are checked every period.
+ */
+class DeadlineWatcher
+{
+
+public:
+
+    /** Constructor. */
+    DeadlineWatcher(
+            const optimizationtools::Timer& timer,
+            CancellationToken& cancellation_token,
+            double period):
+        timer_(timer),
+        cancellation_token_(cancellation_token),
+        period_(period)
+    {
+        if (!(period > 0)) {
+            throw std::invalid_argument(
+                    "The deadline check period must be positive.");
+        }
+    }
+
+    /** Destructor. */
+    ~DeadlineWatcher() { stop(); }
+
+    /** Start the watcher thread. */
+    void start();
+
+    /** Stop the watcher thread. */
+    void stop();
+
+private:
+
+    /** Timer. */
+    const optimizationtools::Timer& timer_;
+
+    /** Cancellation token. */
+    CancellationToken& cancellation_token_;
+
+    /** Period between two checks of the timer in milliseconds. */
+    double period_;
+
+    /** Position of the token among the tokens cancelled on SIGINT. */
+    int sigint_token_pos_ = -1;
+
+    /** Watcher thread. */
+    std::thread thread_;
+
+    /** Mutex used to wake up the watcher thread. */
+    std::mutex mutex_;
+
+    /** Condition variable used to wake up the watcher thread. */
+    std::condition_variable condition_variable_;
+
+    /** True if the watcher thread needs to stop. */
+    bool stop_ = false;
+
+};
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace treesearchsolver
+{
+
+/**
+ * Class to write files in a background thread.
+ *
+ * Only the latest submitted snapshot is kept: if a new snapshot is submitted
+ * before the previous one has been written, the previous one is dropped. This
+ * way, the search thread never waits for file I/O, and a burst of
+ * improvements leads to a single write.
+ */
+class CoalescingWriter
+{
+
+public:
+
+    /** Function writing a snapshot. */
+    using Write = std::function<void()>;
+
+    /** Constructor; starts the thread. */
+    CoalescingWriter();
+
+    /** Destructor; writes the pending snapshot and stops the thread. */
+    ~CoalescingWriter() { stop(); }
+
+    /** Submit a snapshot, replacing the pending one if any. */
+    void submit(Write write);
+
+    /**
+     * Write the pending snapshot and stop the thread.
+     *
+     * Once this method has returned, no more file is written by the writer.
+     */
+    void stop();
+
+    /** Get the number of snapshots written. */
+    int64_t number_of_snapshots_written() const { return number_of_snapshots_written_; }
+
+    /** Get the number of snapshots dropped. */
+    int64_t number_of_snapshots_dropped() const { return number_of_snapshots_dropped_; }
+
+private:
+
+    /** Pending snapshot. */
+    Write pending_write_;
+
+    /** Number of snapshots written. */
+    int64_t number_of_snapshots_written_ = 0;
+
+    /** Number of snapshots dropped. */
+    int64_t number_of_snapshots_dropped_ = 0;
+
+    /** Stop flag. */
+    bool stop_ = false;
+
+    /** Mutex. */
+    std::mutex mutex_;
+
+    /** Condition variable used to wake up the thread. */
+    std::condition_variable condition_variable_;
+
+    /** Thread. */
+    std::thread thread_;
+
+};
+
+/**
+ * Write a file atomically.
+ *
+ * 'write' is called with the path of a temporary file which is then renamed,
+ * so that a reader never sees a partially written file. Throws if the file
+ * can't be renamed.
+ */
+void write_atomically(
+        const std::string& path,
+        const std::function<void(const std::string&)>& write);
+
+}
@@ -1,10 +1,22 @@
 #pragma once
 
+#include "treesearchsolver/cancellation_token.hpp"
+#include "treesearchsolver/telemetry.hpp"
+
 #include "optimizationtools/utils/output.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <memory>
 #include <set>
+#include <sstream>
 #include <iomanip>
+#include <unordered_map>
+#include <vector>
 
 namespace treesearchsolver
 {
@@ -81,6 +93,301 @@ Depth depth(
                     Depth(const std::shared_ptr<typename BranchingScheme::Node>&)>::value>());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////// children ///////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A branching scheme generates the children of a node either one by one, with
+ * 'next_child' and 'infertile', or all at once, with 'children'. A scheme may
+ * provide both; then 'children' returns the remaining children of the node
+ * and makes it infertile.
+ *
+ * Algorithms expanding nodes completely use 'generate_children', which calls
+ * 'children' when the scheme provides it, amortizing the per-child overhead.
+ * Algorithms expanding nodes lazily use a 'ChildGenerator', which calls
+ * 'next_child' when the scheme provides it, so that partially expanded nodes
+ * don't hold all their children.
+ */
+
+template<typename, typename T>
+struct HasChildrenMethod
+{
+    static_assert(
+        std::integral_constant<T, false>::value,
+        "Second template parameter needs to be of function type.");
+};
+
+template<typename C, typename Ret, typename... Args>
+struct HasChildrenMethod<C, Ret(Args...)>
+{
+
+private:
+
+    template<typename T>
+    static constexpr auto check(T*) -> typename std::is_same<decltype(std::declval<T>().children(std::declval<Args>()...)), Ret>::type;
+
+    template<typename>
+    static constexpr std::false_type check(...);
+
+    typedef decltype(check<C>(0)) type;
+
+public:
+
+    static constexpr bool value = type::value;
+
+};
+
+template<typename BranchingScheme>
+using HasChildren = std::integral_constant<
+        bool,
+        HasChildrenMethod<
+            BranchingScheme,
+            std::vector<std::shared_ptr<typename BranchingScheme::Node>>(
+                const std::shared_ptr<typename BranchingScheme::Node>&)>::value>;
+
+template<typename, typename T>
+struct HasNextChildMethod
+{
+    static_assert(
+        std::integral_constant<T, false>::value,
+        "Second template parameter needs to be of function type.");
+};
+
+template<typename C, typename Ret, typename... Args>
+struct HasNextChildMethod<C, Ret(Args...)>
+{
+
+private:
+
+    template<typename T>
+    static constexpr auto check(T*) -> typename std::is_same<decltype(std::declval<T>().next_child(std::declval<Args>()...)), Ret>::type;
+
+    template<typename>
+    static constexpr std::false_type check(...);
+
+    typedef decltype(check<C>(0)) type;
+
+public:
+
+    static constexpr bool value = type::value;
+
+};
+
+template<typename BranchingScheme>
+using HasNextChild = std::integral_constant<
+        bool,
+        HasNextChildMethod<
+            BranchingScheme,
+            std::shared_ptr<typename BranchingScheme::Node>(
+                const std::shared_ptr<typename BranchingScheme::Node>&)>::value>;
+
+template<typename BranchingScheme>
+std::vector<std::shared_ptr<typename BranchingScheme::Node>> generate_children(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<typename BranchingScheme::Node>& node,
+        std::false_type)
+{
+    std::vector<std::shared_ptr<typename BranchingScheme::Node>> children;
+    while (!branching_scheme.infertile(node)) {
+        auto child = branching_scheme.next_child(node);
+        if (child != nullptr)
+            children.push_back(child);
+    }
+    return children;
+}
+
+template<typename BranchingScheme>
+std::vector<std::shared_ptr<typename BranchingScheme::Node>> generate_children(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<typename BranchingScheme::Node>& node,
+        std::true_type)
+{
+    return branching_scheme.children(node);
+}
+
+/**
+ * Generate all the children of a node.
+ */
+template<typename BranchingScheme>
+std::vector<std::shared_ptr<typename BranchingScheme::Node>> generate_children(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<typename BranchingScheme::Node>& node)
+{
+    return generate_children(
+            branching_scheme,
+            node,
+            HasChildren<BranchingScheme>());
+}
+
+/**
+ * Generate the children of nodes one by one.
+ *
+ * If the branching scheme doesn't provide 'next_child', the children of a node
+ * are generated with 'children' the first time they are requested, and
+ * buffered until they have all been returned. Buffers are indexed by node
+ * address and hold a weak pointer to their node, so that the buffers of
+ * deleted nodes are never reused and are eventually released.
+ *
+ * The buffered children hold their parent, which therefore can't be deleted
+ * while its buffer isn't empty. The algorithms must call 'release' when they
+ * discard a node which may still have children to return, or 'clear' when they
+ * discard all their nodes.
+ */
+template<typename BranchingScheme>
+class ChildGenerator
+{
+
+public:
+
+    using Node = typename BranchingScheme::Node;
+
+    /** Constructor. */
+    ChildGenerator(const BranchingScheme& branching_scheme):
+        branching_scheme_(branching_scheme) { }
+
+    /**
+     * Return the next child of a node.
+     *
+     * As for 'BranchingScheme::next_child', the result may be null.
+     */
+    inline std::shared_ptr<Node> next_child(
+            const std::shared_ptr<Node>& node)
+    {
+        return next_child(node, HasNextChild<BranchingScheme>());
+    }
+
+    /** Return 'true' iff all the children of a node have been generated. */
+    inline bool infertile(
+            const std::shared_ptr<Node>& node)
+    {
+        return infertile(node, HasNextChild<BranchingScheme>());
+    }
+
+    /** Release the children of a node which haven't been returned. */
+    inline void release(
+            const std::shared_ptr<Node>& node)
+    {
+        release(node, HasNextChild<BranchingScheme>());
+    }
+
+    /** Release the children of all the nodes which haven't been returned. */
+    inline void clear()
+    {
+        child_buffers_.clear();
+        number_of_child_buffers_ = 0;
+    }
+
+private:
+
+    /** Children of a node which have not been returned yet. */
+    struct ChildBuffer
+    {
+        /** Node. */
+        std::weak_ptr<Node> node;
+
+        /** Children of the node. */
+        std::vector<std::shared_ptr<Node>> children;
+
+        /** Position of the next child to return. */
+        std::size_t pos = 0;
+    };
+
+    inline std::shared_ptr<Node> next_child(
+            const std::shared_ptr<Node>& node,
+            std::true_type)
+    {
+        return branching_scheme_.next_child(node);
+    }
+
+    inline bool infertile(
+            const std::shared_ptr<Node>& node,
+            std::true_type)
+    {
+        return branching_scheme_.infertile(node);
+    }
+
+    inline void release(
+            const std::shared_ptr<Node>&,
+            std::true_type)
+    {
+    }
+
+    inline std::shared_ptr<Node> next_child(
+            const std::shared_ptr<Node>& node,
+            std::false_type)
+    {
+        ChildBuffer& buffer = child_buffer(node);
+        if (buffer.pos == buffer.children.size())
+            return nullptr;
+        std::shared_ptr<Node> child = std::move(buffer.children[buffer.pos]);
+        buffer.pos++;
+        if (buffer.pos == buffer.children.size()) {
+            buffer.children.clear();
+            buffer.children.shrink_to_fit();
+            buffer.pos = 0;
+        }
+        return child;
+    }
+
+    inline bool infertile(
+            const std::shared_ptr<Node>& node,
+            std::false_type)
+    {
+        ChildBuffer& buffer = child_buffer(node);
+        return buffer.pos == buffer.children.size();
+    }
+
+    inline void release(
+            const std::shared_ptr<Node>& node,
+            std::false_type)
+    {
+        child_buffers_.erase(node.get());
+    }
+
+    /**
+     * Return the buffer of a node, generating its children if it doesn't
+     * exist yet.
+     */
+    ChildBuffer& child_buffer(
+            const std::shared_ptr<Node>& node)
+    {
+        auto it = child_buffers_.find(node.get());
+        if (it != child_buffers_.end() && !it->second.node.expired())
+            return it->second;
+
+        // Release the buffers of the deleted nodes once their number has
+        // doubled since the last release.
+        if (child_buffers_.size() >= 2 * number_of_child_buffers_ + 1024) {
+            for (auto it_tmp = child_buffers_.begin();
+                    it_tmp != child_buffers_.end();) {
+                if (it_tmp->second.node.expired()) {
+                    it_tmp = child_buffers_.erase(it_tmp);
+                } else {
+                    ++it_tmp;
+                }
+            }
+            number_of_child_buffers_ = child_buffers_.size();
+        }
+
+        ChildBuffer& buffer = child_buffers_[node.get()];
+        buffer.node = node;
+        buffer.children = branching_scheme_.children(node);
+        buffer.pos = 0;
+        return buffer;
+    }
+
+    /** Branching scheme. */
+    const BranchingScheme& branching_scheme_;
+
+    /** Buffers of the nodes being expanded. */
+    std::unordered_map<const Node*, ChildBuffer> child_buffers_;
+
+    /** Number of buffers after the last release. */
+    std::size_t number_of_child_buffers_ = 0;
+
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////// goal_node ///////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -145,9 +452,271 @@ std::shared_ptr<typename BranchingScheme::Node> goal_node(
                 std::shared_ptr<typename BranchingScheme::Node>(double)>::value>());
 }
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////// Solution Pool /////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////// value /////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename, typename T>
+struct HasValueMethod
+{
+    static_assert(
+        std::integral_constant<T, false>::value,
+        "Second template parameter needs to be of function type.");
+};
+
+template<typename C, typename Ret, typename... Args>
+struct HasValueMethod<C, Ret(Args...)>
+{
+
+private:
+
+    template<typename T>
+    static constexpr auto check(T*) -> typename std::is_same<decltype(std::declval<T>().value(std::declval<Args>()...)), Ret>::type;
+
+    template<typename>
+    static constexpr std::false_type check(...);
+
+    typedef decltype(check<C>(0)) type;
+
+public:
+
+    static constexpr bool value = type::value;
+
+};
+
+template<typename BranchingScheme>
+Value value(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<typename BranchingScheme::Node>& node,
+        std::false_type)
+{
+    // Fall back to the number at the beginning of the displayed value. This
+    // is fragile, branching schemes should rather provide 'value'.
+    std::string s = branching_scheme.display(node);
+    char* end = nullptr;
+    Value v = std::strtod(s.c_str(), &end);
+    if (end == s.c_str())
+        return std::numeric_limits<Value>::quiet_NaN();
+    return v;
+}
+
+template<typename BranchingScheme>
+Value value(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<typename BranchingScheme::Node>& node,
+        std::true_type)
+{
+    return branching_scheme.value(node);
+}
+
+/**
+ * Get the value of a solution.
+ *
+ * Returns NaN if the node is not a solution.
+ *
+ * Calls 'BranchingScheme::value' if the branching scheme provides it;
+ * otherwise, parses the number at the beginning of 'display'.
+ */
+template<typename BranchingScheme>
+Value value(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<typename BranchingScheme::Node>& node)
+{
+    return value(
+            branching_scheme,
+            node,
+            std::integral_constant<
+                bool,
+                HasValueMethod<BranchingScheme,
+                Value(const std::shared_ptr<typename BranchingScheme::Node>&)>::value>());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////// set_cancellation_token ////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename, typename T>
+struct HasSetCancellationTokenMethod
+{
+    static_assert(
+        std::integral_constant<T, false>::value,
+        "Second template parameter needs to be of function type.");
+};
+
+template<typename C, typename Ret, typename... Args>
+struct HasSetCancellationTokenMethod<C, Ret(Args...)>
+{
+
+private:
+
+    template<typename T>
+    static constexpr auto check(T*) -> typename std::is_same<decltype(std::declval<T>().set_cancellation_token(std::declval<Args>()...)), Ret>::type;
+
+    template<typename>
+    static constexpr std::false_type check(...);
+
+    typedef decltype(check<C>(0)) type;
+
+public:
+
+    static constexpr bool value = type::value;
+
+};
+
+template<typename BranchingScheme>
+void set_cancellation_token(
+        const BranchingScheme&,
+        const std::shared_ptr<CancellationToken>&,
+        std::false_type)
+{
+}
+
+template<typename BranchingScheme>
+void set_cancellation_token(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<CancellationToken>& cancellation_token,
+        std::true_type)
+{
+    branching_scheme.set_cancellation_token(cancellation_token);
+}
+
+/**
+ * Give the cancellation token of an algorithm to a branching scheme.
+ *
+ * Calls 'BranchingScheme::set_cancellation_token' if the branching scheme
+ * provides it, so that a scheme whose children may take long to generate can
+ * stop generating them once the algorithm is cancelled.
+ */
+template<typename BranchingScheme>
+void set_cancellation_token(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<CancellationToken>& cancellation_token)
+{
+    set_cancellation_token(
+            branching_scheme,
+            cancellation_token,
+            std::integral_constant<
+                bool,
+                HasSetCancellationTokenMethod<BranchingScheme,
+                void(const std::shared_ptr<CancellationToken>&)>::value>());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////// to_json ////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename, typename T>
+struct HasToJsonMethod
+{
+    static_assert(
+        std::integral_constant<T, false>::value,
+        "Second template parameter needs to be of function type.");
+};
+
+template<typename C, typename Ret, typename... Args>
+struct HasToJsonMethod<C, Ret(Args...)>
+{
+
+private:
+
+    template<typename T>
+    static constexpr auto check(T*) -> typename std::is_same<decltype(std::declval<T>().to_json(std::declval<Args>()...)), Ret>::type;
+
+    template<typename>
+    static constexpr std::false_type check(...);
+
+    typedef decltype(check<C>(0)) type;
+
+public:
+
+    static constexpr bool value = type::value;
+
+};
+
+template<typename BranchingScheme>
+nlohmann::json branching_scheme_to_json(
+        const BranchingScheme&,
+        std::false_type)
+{
+    return nullptr;
+}
+
+template<typename BranchingScheme>
+nlohmann::json branching_scheme_to_json(
+        const BranchingScheme& branching_scheme,
+        std::true_type)
+{
+    return branching_scheme.to_json();
+}
+
+/**
+ * Get the JSON statistics of a branching scheme.
+ *
+ * Calls 'BranchingScheme::to_json' if the branching scheme provides it, e.g.
+ * to report that it didn't generate all the children of some nodes;
+ * otherwise, returns null.
+ */
+template<typename BranchingScheme>
+nlohmann::json branching_scheme_to_json(
+        const BranchingScheme& branching_scheme)
+{
+    return branching_scheme_to_json(
+            branching_scheme,
+            std::integral_constant<
+                bool,
+                HasToJsonMethod<BranchingScheme,
+                nlohmann::json()>::value>());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////// Solution Pool /////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+using Fingerprint = uint64_t;
+
+/**
+ * Optional 'fingerprint' method of a branching scheme.
+ *
+ * The fingerprint of a node is a hash of the solution it represents, which
+ * should be cheap to get, e.g. accumulated during branching and stored in the
+ * node. If the branching scheme provides it, the solution pool considers two
+ * solutions with the same value and the same fingerprint as duplicates
+ * instead of calling 'equals'.
+ */
+template<typename, typename T>
+struct HasFingerprintMethod
+{
+    static_assert(
+        std::integral_constant<T, false>::value,
+        "Second template parameter needs to be of function type.");
+};
+
+template<typename C, typename Ret, typename... Args>
+struct HasFingerprintMethod<C, Ret(Args...)>
+{
+
+private:
+
+    template<typename T>
+    static constexpr auto check(T*) -> typename std::is_same<decltype(std::declval<T>().fingerprint(std::declval<Args>()...)), Ret>::type;
+
+    template<typename>
+    static constexpr std::false_type check(...);
+
+    typedef decltype(check<C>(0)) type;
+
+public:
+
+    static constexpr bool value = type::value;
+
+};
+
+template<typename BranchingScheme>
+using HasFingerprint = std::integral_constant<
+        bool,
+        HasFingerprintMethod<
+            BranchingScheme,
+            Fingerprint(const std::shared_ptr<typename BranchingScheme::Node>&)>::value>;
 
 template <typename BranchingScheme>
 struct SolutionPoolComparator
@@ -166,10 +735,33 @@ struct SolutionPoolComparator
             return true;
         if (branching_scheme.better(node_2, node_1))
             return false;
+        return compare_equivalent(
+                node_1,
+                node_2,
+                HasFingerprint<BranchingScheme>());
+    }
+
+private:
+
+    /** Compare two solutions with the same value. */
+    bool compare_equivalent(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2,
+            std::false_type) const
+    {
         if (branching_scheme.equals(node_1, node_2))
             return false;
         return node_1.get() < node_2.get();
     }
+
+    bool compare_equivalent(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2,
+            std::true_type) const
+    {
+        return branching_scheme.fingerprint(node_1)
+            < branching_scheme.fingerprint(node_2);
+    }
 };
 
 /**
@@ -247,6 +839,111 @@ private:
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Statistics on the accesses to the history.
+ */
+struct HistoryStatistics
+{
+    /** Number of lookups in the history. */
+    Counter number_of_lookups = 0;
+
+    /**
+     * Distribution of the length of the lists of the history at lookup.
+     *
+     * Entry 0 counts the lookups of empty lists, entry k > 0 counts the
+     * lookups of lists of length in [2^(k-1), 2^k).
+     */
+    std::vector<Counter> list_length_histogram;
+
+    /** Number of dominance checks. */
+    Counter number_of_dominance_checks = 0;
+
+    /** Number of nodes rejected because dominated. */
+    Counter number_of_dominated_nodes = 0;
+
+    /** Number of nodes removed from the queue because dominated. */
+    Counter number_of_evicted_nodes = 0;
+
+    /**
+     * Number of states compared to the state of a looked up node, i.e. the
+     * number of other states in the same bucket of the hash table.
+     */
+    Counter number_of_bucket_collisions = 0;
+
+    /**
+     * Number of states with the same hash as a looked up node but a different
+     * state, i.e. the equality comparisons of the node hasher returning false
+     * after a hash match.
+     */
+    Counter number_of_hash_collisions = 0;
+
+
+    /** Update the statistics with the lookup of a list of a given length. */
+    void add_lookup(std::size_t list_length);
+
+    nlohmann::json to_json() const;
+
+    void format(
+            std::ostream& os,
+            int width) const;
+};
+
+/**
+ * Anytime performance profile of an algorithm.
+ *
+ * The primal gap of a value v with respect to a reference value r is
+ * |r - v| / max(|r|, |v|); it is 0 if both values are 0 and 1 if they have
+ * different signs. The primal gap before the first solution is 1.
+ */
+struct AnytimeProfile
+{
+    /** Number of improving solutions. */
+    Counter number_of_solutions = 0;
+
+    /** Reference value used to compute the primal gaps. */
+    Value reference_value = std::numeric_limits<Value>::quiet_NaN();
+
+    /** Target primal gap. */
+    double target_gap = 0.0;
+
+    /** Time to the first solution, -1 if no solution was found. */
+    double time_to_first_solution = -1;
+
+    /**
+     * Time to the first solution within the target primal gap, -1 if the
+     * target was not reached.
+     */
+    double time_to_target = -1;
+
+    /** Integral over time of the primal gap. */
+    double primal_integral = 0.0;
+
+
+    nlohmann::json to_json() const;
+
+    void format(
+            std::ostream& os,
+            int width) const;
+};
+
+/** Primal gap of a value with respect to a reference value. */
+double primal_gap(
+        Value value,
+        Value reference_value);
+
+/**
+ * Compute the anytime profile of an algorithm.
+ *
+ * 'solutions' contains the times and values of the successive improving
+ * solutions. If 'reference_value' is NaN, the value of the last solution is
+ * used.
+ */
+AnytimeProfile compute_anytime_profile(
+        const std::vector<std::pair<double, Value>>& solutions,
+        double end_time,
+        Value reference_value,
+        double target_gap);
+
 template <typename BranchingScheme>
 struct Output: optimizationtools::Output
 {
@@ -263,12 +960,44 @@ struct Output: optimizationtools::Output
     /** Elapsed time. */
     double time = 0.0;
 
+    /**
+     * History statistics.
+     *
+     * They are only written in the final output, not in the intermediary
+     * outputs.
+     */
+    HistoryStatistics history_statistics;
+
+    /** Anytime profile, computed at the end of the algorithm. */
+    AnytimeProfile anytime_profile;
+
+    /**
+     * Time between the cancellation and the end of the algorithm in seconds.
+     *
+     * NaN if the algorithm hasn't been cancelled.
+     */
+    double stop_latency = std::numeric_limits<double>::quiet_NaN();
+
 
     virtual nlohmann::json to_json() const
     {
-        return {
+        nlohmann::json json = {
             {"Value", solution_pool.branching_scheme().display(solution_pool.best())},
             {"Time", time}};
+        Value numeric_value = value(
+                solution_pool.branching_scheme(),
+                solution_pool.best());
+        if (!std::isnan(numeric_value))
+            json["NumericValue"] = numeric_value;
+        if (!std::isnan(stop_latency))
+            json["StopLatency"] = stop_latency;
+        if (anytime_profile.number_of_solutions > 0)
+            json["AnytimeProfile"] = anytime_profile.to_json();
+        nlohmann::json branching_scheme_json = branching_scheme_to_json(
+                solution_pool.branching_scheme());
+        if (!branching_scheme_json.is_null())
+            json["BranchingScheme"] = branching_scheme_json;
+        return json;
     }
 
     virtual int format_width() const { return 30; }
@@ -280,6 +1009,12 @@ struct Output: optimizationtools::Output
             << std::setw(width) << std::left << "Value: " << solution_pool.branching_scheme().display(solution_pool.best()) << std::endl
             << std::setw(width) << std::left << "Time: " << time << std::endl
             ;
+        if (!std::isnan(stop_latency))
+            os << std::setw(width) << std::left << "Stop latency: " << stop_latency << std::endl;
+        if (history_statistics.number_of_lookups > 0)
+            history_statistics.format(os, width);
+        if (anytime_profile.number_of_solutions > 0)
+            anytime_profile.format(os, width);
     }
 };
 
@@ -312,6 +1047,77 @@ struct Parameters: optimizationtools::Parameters
      */
     std::shared_ptr<Node> cutoff = nullptr;
 
+    /**
+     * Cancellation token.
+     *
+     * If not 'nullptr', the algorithm stops once it is cancelled. It may be
+     * cancelled from another thread while the algorithm runs.
+     *
+     * The algorithm also cancels it when the timer needs to end, and a token
+     * can't be reset, so a token can't be reused across solves.
+     */
+    std::shared_ptr<CancellationToken> cancellation_token = nullptr;
+
+    /**
+     * Period between two checks of the timer in milliseconds.
+     *
+     * A background thread cancels the algorithm once the timer needs to end,
+     * so that the algorithms don't read the clock at each node. It wakes up
+     * at the time limit, and checks the other reasons for the timer to end
+     * every period in between. SIGINT doesn't depend on it if the handler of
+     * 'set_sigint_handler' is installed. It must be positive.
+     */
+    double deadline_check_period = 100;
+
+    /**
+     * Path of the trace file.
+     *
+     * If not empty, a timeline of the search is written in this file in the
+     * Chrome trace-event format at the end of the algorithm.
+     */
+    std::string trace_path = "";
+
+    /**
+     * Path of the events file.
+     *
+     * If not empty, the start, the new solutions, the ends of iterations and
+     * the end of the algorithm are appended to this file in the JSON Lines
+     * format as they occur.
+     */
+    std::string events_path = "";
+
+    /**
+     * Collect statistics on the history.
+     *
+     * This requires hashing the other states of the hash table bucket of
+     * each looked up node to count the collisions.
+     */
+    bool history_statistics = false;
+
+    /**
+     * Reference value of the anytime profile.
+     *
+     * If NaN, the value of the final solution is used.
+     */
+    Value reference_value = std::numeric_limits<Value>::quiet_NaN();
+
+    /** Target primal gap of the anytime profile. */
+    double target_gap = 0.01;
+
+    /**
+     * Path of the telemetry file.
+     *
+     * If not empty, a background thread periodically writes a snapshot of the
+     * search metrics in this file.
+     */
+    std::string telemetry_path = "";
+
+    /** Format of the telemetry file. */
+    TelemetryFormat telemetry_format = TelemetryFormat::Prometheus;
+
+    /** Period between two telemetry snapshots in milliseconds. */
+    double telemetry_period = 1000;
+
 
     virtual nlohmann::json to_json() const override
     {
@@ -319,7 +1125,19 @@ struct Parameters: optimizationtools::Parameters
         json.merge_patch({
                 {"MaximumSizeOfTheSolutionPool", maximum_size_of_the_solution_pool},
                 {"HasGoal", (goal != nullptr)},
-                {"HasCutoff", (cutoff != nullptr)}});
+                {"HasCutoff", (cutoff != nullptr)},
+                {"HistoryStatistics", history_statistics},
+                {"TargetGap", target_gap},
+                {"DeadlineCheckPeriod", deadline_check_period},
+                {"TracePath", trace_path},
+                {"EventsPath", events_path},
+                {"TelemetryPath", telemetry_path},
+                {"TelemetryPeriod", telemetry_period}});
+        if (!std::isnan(reference_value))
+            json["ReferenceValue"] = reference_value;
+        std::stringstream telemetry_format_ss;
+        telemetry_format_ss << telemetry_format;
+        json["TelemetryFormat"] = telemetry_format_ss.str();
         return json;
     }
 
@@ -333,6 +1151,15 @@ struct Parameters: optimizationtools::Parameters
             << std::setw(width) << std::left << "Maximum size of the solution pool: " << maximum_size_of_the_solution_pool << std::endl
             << std::setw(width) << std::left << "Has goal: " << (goal != nullptr) << std::endl
             << std::setw(width) << std::left << "Has cutoff: " << (cutoff != nullptr) << std::endl
+            << std::setw(width) << std::left << "History statistics: " << history_statistics << std::endl
+            << std::setw(width) << std::left << "Reference value: " << reference_value << std::endl
+            << std::setw(width) << std::left << "Target gap: " << target_gap << std::endl
+            << std::setw(width) << std::left << "Deadline check period: " << deadline_check_period << std::endl
+            << std::setw(width) << std::left << "Trace path: " << trace_path << std::endl
+            << std::setw(width) << std::left << "Events path: " << events_path << std::endl
+            << std::setw(width) << std::left << "Telemetry path: " << telemetry_path << std::endl
+            << std::setw(width) << std::left << "Telemetry format: " << telemetry_format << std::endl
+            << std::setw(width) << std::left << "Telemetry period: " << telemetry_period << std::endl
             ;
     }
 };
@@ -341,10 +1168,95 @@ struct Parameters: optimizationtools::Parameters
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////// dominance_key /////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A branching scheme may provide a 'dominance_key' method, returning a value
+ * such that if 'node_1' dominates 'node_2', then the key of 'node_1' is
+ * smaller than or equal to the key of 'node_2'.
+ *
+ * The lists of the history are then kept sorted by key. A node is only
+ * checked against the nodes with the closest smaller or equal keys to know if
+ * it is dominated, and against the nodes with the closest greater or equal
+ * keys to know which nodes it dominates, at most 'dominance_check_window' on
+ * each side. Dominance only prunes the search: the comparisons skipped in long
+ * lists only keep more nodes, and the cost of adding a node to a list doesn't
+ * grow with its length. The key should be cheap to compute, e.g. stored in
+ * the node.
+ */
+template<typename, typename T>
+struct HasDominanceKeyMethod
+{
+    static_assert(
+        std::integral_constant<T, false>::value,
+        "Second template parameter needs to be of function type.");
+};
+
+template<typename C, typename Ret, typename... Args>
+struct HasDominanceKeyMethod<C, Ret(Args...)>
+{
+
+private:
+
+    template<typename T>
+    static constexpr auto check(T*) -> typename std::is_same<decltype(std::declval<T>().dominance_key(std::declval<Args>()...)), Ret>::type;
+
+    template<typename>
+    static constexpr std::false_type check(...);
+
+    typedef decltype(check<C>(0)) type;
+
+public:
+
+    static constexpr bool value = type::value;
+
+};
+
+template<typename BranchingScheme>
+using HasDominanceKey = std::integral_constant<
+        bool,
+        HasDominanceKeyMethod<
+            BranchingScheme,
+            double(const std::shared_ptr<typename BranchingScheme::Node>&)>::value>;
+
+/**
+ * Maximum number of nodes a node is compared to on each side of its key when
+ * it is added to a sorted list of the history.
+ */
+constexpr NodeId dominance_check_window = 64;
+
+/**
+ * List of the history of a branching scheme with a dominance key.
+ *
+ * The nodes are sorted by key, so that they are added and removed in
+ * logarithmic time. The key of a node alone in its list is only computed once
+ * another node is added to the list.
+ */
+template <typename Node>
+struct SortedHistoryList
+{
+    /** Node alone in the list, whose key hasn't been computed. */
+    std::shared_ptr<Node> single_node = nullptr;
+
+    /** Nodes sorted by key. */
+    std::multimap<double, std::shared_ptr<Node>> nodes;
+
+    /** Get the number of nodes of the list. */
+    std::size_t size() const { return (single_node != nullptr)? 1: nodes.size(); }
+};
+
+template <typename BranchingScheme>
+using HistoryList = typename std::conditional<
+        HasDominanceKey<BranchingScheme>::value,
+        SortedHistoryList<typename BranchingScheme::Node>,
+        std::vector<std::shared_ptr<typename BranchingScheme::Node>>>::type;
+
 template <typename BranchingScheme>
 using NodeMap = std::unordered_map<
         std::shared_ptr<typename BranchingScheme::Node>,
-        std::vector<std::shared_ptr<typename BranchingScheme::Node>>,
+        HistoryList<BranchingScheme>,
         const typename BranchingScheme::NodeHasher&,
         const typename BranchingScheme::NodeHasher&>;
 
@@ -353,38 +1265,184 @@ using NodeSet = std::set<
         std::shared_ptr<typename BranchingScheme::Node>,
         const BranchingScheme&>;
 
+/**
+ * Update the collision statistics with the lookup of a node in the history.
+ */
+template <typename BranchingScheme>
+inline void update_collision_statistics(
+        NodeMap<BranchingScheme>& history,
+        const std::shared_ptr<typename BranchingScheme::Node>& node,
+        HistoryStatistics& history_statistics)
+{
+    const auto& hasher = history.hash_function();
+    std::size_t hash = hasher(node);
+    std::size_t bucket = history.bucket(node);
+    for (auto it = history.begin(bucket); it != history.end(bucket); ++it) {
+        if (hasher(it->first, node))
+            continue;
+        history_statistics.number_of_bucket_collisions++;
+        if (hasher(it->first) == hash)
+            history_statistics.number_of_hash_collisions++;
+    }
+}
+
+/**
+ * Remove a node from a queue and release its children.
+ *
+ * The children are only released if the node was in the queue; otherwise, it
+ * may be the node being expanded.
+ */
+template <typename BranchingScheme>
+inline void remove_from_queue(
+        NodeSet<BranchingScheme>& q,
+        const std::shared_ptr<typename BranchingScheme::Node>& node,
+        ChildGenerator<BranchingScheme>* child_generator)
+{
+    if (q.erase(node) > 0 && child_generator != nullptr)
+        child_generator->release(node);
+}
+
+/**
+ * Add a node to a list of the history, unless it is dominated, and remove
+ * from the list and from the queue the nodes it dominates.
+ *
+ * If 'child_generator' is not 'nullptr', the children of the nodes removed
+ * from the queue are released.
+ *
+ * Return 'false' if the node is dominated.
+ */
+template <typename BranchingScheme>
+inline bool add_to_history_list(
+        const BranchingScheme& branching_scheme,
+        std::vector<std::shared_ptr<typename BranchingScheme::Node>>& list,
+        NodeSet<BranchingScheme>& q,
+        const std::shared_ptr<typename BranchingScheme::Node>& node,
+        HistoryStatistics* history_statistics,
+        ChildGenerator<BranchingScheme>* child_generator)
+{
+    using Node = typename BranchingScheme::Node;
+
+    // Check if node is dominated.
+    for (const std::shared_ptr<Node>& n: list) {
+        if (history_statistics != nullptr)
+            history_statistics->number_of_dominance_checks++;
+        if (branching_scheme.dominates(n, node)) {
+            if (history_statistics != nullptr)
+                history_statistics->number_of_dominated_nodes++;
+            return false;
+        }
+    }
+
+    // Remove dominated nodes from history.
+    for (auto it = list.begin(); it != list.end();) {
+        if (history_statistics != nullptr)
+            history_statistics->number_of_dominance_checks++;
+        if (branching_scheme.dominates(node, *it)) {
+            if (history_statistics != nullptr)
+                history_statistics->number_of_evicted_nodes++;
+            remove_from_queue(q, *it, child_generator);
+            *it = list.back();
+            list.pop_back();
+        } else {
+            ++it;
+        }
+    }
+
+    // Add node to history.
+    list.push_back(node);
+    return true;
+}
+
+template <typename BranchingScheme>
+inline bool add_to_history_list(
+        const BranchingScheme& branching_scheme,
+        SortedHistoryList<typename BranchingScheme::Node>& list,
+        NodeSet<BranchingScheme>& q,
+        const std::shared_ptr<typename BranchingScheme::Node>& node,
+        HistoryStatistics* history_statistics,
+        ChildGenerator<BranchingScheme>* child_generator)
+{
+    // The key of a node is only required when it is compared to other nodes.
+    if (list.single_node == nullptr && list.nodes.empty()) {
+        list.single_node = node;
+        return true;
+    }
+    if (list.single_node != nullptr) {
+        list.nodes.insert(std::make_pair(
+                    branching_scheme.dominance_key(list.single_node),
+                    list.single_node));
+        list.single_node = nullptr;
+    }
+    double key = branching_scheme.dominance_key(node);
+
+    // Check if node is dominated, by the nodes with the closest smaller or
+    // equal keys.
+    auto it = list.nodes.upper_bound(key);
+    for (NodeId pos = 0;
+            pos < dominance_check_window && it != list.nodes.begin();
+            ++pos) {
+        --it;
+        if (history_statistics != nullptr)
+            history_statistics->number_of_dominance_checks++;
+        if (branching_scheme.dominates(it->second, node)) {
+            if (history_statistics != nullptr)
+                history_statistics->number_of_dominated_nodes++;
+            return false;
+        }
+    }
+
+    // Remove dominated nodes from history, among the nodes with the closest
+    // greater or equal keys.
+    it = list.nodes.lower_bound(key);
+    for (NodeId pos = 0;
+            pos < dominance_check_window && it != list.nodes.end();
+            ++pos) {
+        if (history_statistics != nullptr)
+            history_statistics->number_of_dominance_checks++;
+        if (branching_scheme.dominates(node, it->second)) {
+            if (history_statistics != nullptr)
+                history_statistics->number_of_evicted_nodes++;
+            remove_from_queue(q, it->second, child_generator);
+            it = list.nodes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Add node to history, after the nodes with the same key.
+    list.nodes.insert(std::make_pair(key, node));
+    return true;
+}
+
 template <typename BranchingScheme>
 inline bool add_to_history_and_queue(
         const BranchingScheme& branching_scheme,
         NodeMap<BranchingScheme>& history,
         NodeSet<BranchingScheme>& q,
-        const std::shared_ptr<typename BranchingScheme::Node>& node)
+        const std::shared_ptr<typename BranchingScheme::Node>& node,
+        HistoryStatistics* history_statistics = nullptr,
+        ChildGenerator<BranchingScheme>* child_generator = nullptr)
 {
-    using Node = typename BranchingScheme::Node;
     assert(node != nullptr);
 
     // If node is not comparable, stop.
     if (branching_scheme.comparable(node)) {
-        auto& list = history[node];
+        if (history_statistics != nullptr)
+            update_collision_statistics<BranchingScheme>(history, node, *history_statistics);
 
-        // Check if node is dominated.
-        for (const std::shared_ptr<Node>& n: list)
-            if (branching_scheme.dominates(n, node))
-                return false;
-
-        // Remove dominated nodes from history.
-        for (auto it = list.begin(); it != list.end();) {
-            if (branching_scheme.dominates(node, *it)) {
-                q.erase(*it);
-                *it = list.back();
-                list.pop_back();
-            } else {
-                ++it;
-            }
+        auto& list = history[node];
+        if (history_statistics != nullptr)
+            history_statistics->add_lookup(list.size());
+
+        if (!add_to_history_list(
+                    branching_scheme,
+                    list,
+                    q,
+                    node,
+                    history_statistics,
+                    child_generator)) {
+            return false;
         }
-
-        // Add node to history.
-        list.push_back(node);
     }
 
     // Add to queue.
@@ -392,26 +1450,63 @@ inline bool add_to_history_and_queue(
     return true;
 }
 
+/**
+ * Remove a node from a list of the history.
+ */
+template <typename BranchingScheme>
+inline void remove_from_history_list(
+        const BranchingScheme&,
+        std::vector<std::shared_ptr<typename BranchingScheme::Node>>& list,
+        const std::shared_ptr<typename BranchingScheme::Node>& node)
+{
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        if (*it == node) {
+            *it = list.back();
+            list.pop_back();
+            return;
+        }
+    }
+}
+
+template <typename BranchingScheme>
+inline void remove_from_history_list(
+        const BranchingScheme& branching_scheme,
+        SortedHistoryList<typename BranchingScheme::Node>& list,
+        const std::shared_ptr<typename BranchingScheme::Node>& node)
+{
+    if (list.single_node != nullptr) {
+        if (list.single_node == node)
+            list.single_node = nullptr;
+        return;
+    }
+    if (list.nodes.empty())
+        return;
+    auto range = list.nodes.equal_range(branching_scheme.dominance_key(node));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == node) {
+            list.nodes.erase(it);
+            return;
+        }
+    }
+}
+
 template <typename BranchingScheme>
 inline void remove_from_history(
         const BranchingScheme& branching_scheme,
         NodeMap<BranchingScheme>& history,
-        const std::shared_ptr<typename BranchingScheme::Node>& node)
+        const std::shared_ptr<typename BranchingScheme::Node>& node,
+        HistoryStatistics* history_statistics = nullptr)
 {
     // Remove from history.
     if (branching_scheme.comparable(node)) {
+        if (history_statistics != nullptr)
+            update_collision_statistics<BranchingScheme>(history, node, *history_statistics);
         auto& list = history[node];
-        for (auto it = list.begin(); it != list.end();) {
-            if (*it == node) {
-                *it = list.back();
-                list.pop_back();
-                if (list.empty())
-                    history.erase(node);
-                break;
-            } else {
-                ++it;
-            }
-        }
+        if (history_statistics != nullptr)
+            history_statistics->add_lookup(list.size());
+        remove_from_history_list(branching_scheme, list, node);
+        if (list.size() == 0)
+            history.erase(node);
     }
 }
 
@@ -420,10 +1515,15 @@ inline void remove_from_history_and_queue(
         const BranchingScheme& branching_scheme,
         NodeMap<BranchingScheme>& history,
         std::set<std::shared_ptr<typename BranchingScheme::Node>, const BranchingScheme&>& q,
-        typename NodeSet<BranchingScheme>::const_iterator node)
+        typename NodeSet<BranchingScheme>::const_iterator node,
+        HistoryStatistics* history_statistics = nullptr,
+        ChildGenerator<BranchingScheme>* child_generator = nullptr)
 {
     // Remove from history.
-    remove_from_history(branching_scheme, history, *node);
+    remove_from_history(branching_scheme, history, *node, history_statistics);
+    // Release its children.
+    if (child_generator != nullptr)
+        child_generator->release(*node);
     // Remove from queue.
     q.erase(node);
 }
@@ -497,4 +1597,47 @@ void solution_write(
                 void(const std::shared_ptr<typename BranchingScheme::Node>&, const std::string&)>::value>());
 }
 
+template<typename BranchingScheme>
+bool solution_write(
+        const BranchingScheme&,
+        const std::shared_ptr<typename BranchingScheme::Node>&,
+        std::ostream&,
+        std::false_type)
+{
+    return false;
+}
+
+template<typename BranchingScheme>
+bool solution_write(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<typename BranchingScheme::Node>& solution,
+        std::ostream& os,
+        std::true_type)
+{
+    branching_scheme.solution_write(solution, os);
+    return true;
+}
+
+/**
+ * Write the certificate of a solution in a stream.
+ *
+ * Returns 'false', without writing anything, if the branching scheme doesn't
+ * provide a 'solution_write' method writing in a stream.
+ */
+template<typename BranchingScheme>
+bool solution_write(
+        const BranchingScheme& branching_scheme,
+        const std::shared_ptr<typename BranchingScheme::Node>& solution,
+        std::ostream& os)
+{
+    return solution_write(
+            branching_scheme,
+            solution,
+            os,
+            std::integral_constant<
+                bool,
+                HasSolutionWriteMethod<BranchingScheme,
+                void(const std::shared_ptr<typename BranchingScheme::Node>&, std::ostream&)>::value>());
+}
+
 }
@@ -88,7 +88,7 @@ inline const DepthFirstSearchOutput<BranchingScheme> depth_first_search(
     while (!q.empty()) {
 
         // Check time.
-        if (parameters.timer.needs_to_end())
+        if (algorithm_formatter.needs_to_end())
             break;
 
         // Check node limit.
@@ -109,12 +109,7 @@ inline const DepthFirstSearchOutput<BranchingScheme> depth_first_search(
         q.pop_back();
 
         std::vector<std::shared_ptr<Node>> children;
-        while (!branching_scheme.infertile(current_node)) {
-
-            // Get next child.
-            auto child = branching_scheme.next_child(current_node);
-            if (child == nullptr)
-                continue;
+        for (const auto& child: generate_children(branching_scheme, current_node)) {
 
             // Update best solution.
             if (branching_scheme.better(child, output.solution_pool.worst())) {
@@ -157,6 +152,10 @@ inline const DepthFirstSearchOutput<BranchingScheme> depth_first_search(
             q.push_back(child);
 
         output.number_of_nodes++;
+        algorithm_formatter.update_telemetry(
+                output.number_of_nodes,
+                q.size(),
+                0);
     }
 
     algorithm_formatter.end();
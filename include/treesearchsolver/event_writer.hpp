@@ -0,0 +1,54 @@
+#pragma once
+
+#include "treesearchsolver/common.hpp"
+
+#include <fstream>
+#include <string>
+
+namespace treesearchsolver
+{
+
+/**
+ * Class to write the events of the search in the JSON Lines format.
+ *
+ * Each event (start, new solution, end of iteration, end) is appended to the
+ * file as a single line as soon as it occurs. Contrary to rewriting the whole
+ * JSON output at each new solution, the cost of an event doesn't depend on
+ * the number of previous events.
+ */
+class EventWriter
+{
+
+public:
+
+    /** Constructor; truncates the file. */
+    EventWriter(const std::string& events_path);
+
+    /**
+     * Write an event.
+     *
+     * The line contains the name and the time of the event, followed by the
+     * members of 'data'.
+     */
+    void write(
+            const std::string& event,
+            double time,
+            const nlohmann::json& data = nlohmann::json::object());
+
+    /** Get the number of events written. */
+    Counter number_of_events() const { return number_of_events_; }
+
+private:
+
+    /** Path of the events file. */
+    std::string events_path_;
+
+    /** Events file. */
+    std::ofstream file_;
+
+    /** Number of events written. */
+    Counter number_of_events_ = 0;
+
+};
+
+}
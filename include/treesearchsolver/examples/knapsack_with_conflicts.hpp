@@ -14,13 +14,37 @@
  *   - weight(node_1) <= weight(node_2)
  *   then node_1 dominates node_2
  *
+ * Canonical branching ('canonical' parameter):
+ * - Items are sorted by non-increasing efficiency (profit / weight). A child
+ *   only adds an item ranked after the last item added, so that each subset
+ *   of items is generated once. The items ranked before the last item added
+ *   are removed from the available items of the node, so that the dominance
+ *   above remains valid.
+ *
+ * Bound ('bound_id' parameter):
+ * - 0: profit of the partial solution plus profit of the remaining available
+ *   items
+ * - 1: profit of the partial solution plus fractional relaxation of the
+ *   knapsack problem on the remaining available items with the remaining
+ *   capacity (conflicts are relaxed)
+ *
+ * The available items of a node are stored as a bitset. For each item, the
+ * bitset of the item and its conflicting items is precomputed, so that the
+ * available items of a child are computed with one AND-NOT per word.
+ *
  */
 
 #pragma once
 
+#include "optimizationtools/utils/utils.hpp"
+
 #include "orproblems/packing/knapsack_with_conflicts.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <random>
 #include <sstream>
 
 namespace treesearchsolver
@@ -32,6 +56,9 @@ using namespace orproblems::knapsack_with_conflicts;
 
 using NodeId = int64_t;
 using GuideId = int64_t;
+using BoundId = int64_t;
+using Word = uint64_t;
+using WordPos = int64_t;
 
 class BranchingScheme
 {
@@ -41,6 +68,12 @@ public:
     struct Parameters
     {
         GuideId guide_id = 0;
+
+        /** Only add items ranked after the last item added. */
+        bool canonical = false;
+
+        /** Bound. */
+        BoundId bound_id = 0;
     };
 
     struct Node
@@ -48,8 +81,12 @@ public:
         /** Parent node. */
         std::shared_ptr<Node> parent = nullptr;
 
-        /** Array indicating for each item, if it still available. */
-        std::vector<bool> available_items;
+        /**
+         * Bitset indicating for each item, if it still available.
+         *
+         * Item 'j' is bit 'j % 64' of word 'j / 64'.
+         */
+        std::vector<Word> available_items;
 
         /** Last item added to the partial solution. */
         ItemId item_id = -1;
@@ -72,10 +109,23 @@ public:
         /** Profit of the partial solution. */
         Profit profit = 0;
 
+        /** Upper bound on the profit of the solutions of the subtree. */
+        Profit upper_bound = 0;
+
+        /**
+         * Fingerprint of the partial solution, i.e. XOR of the random keys of
+         * its items.
+         */
+        uint64_t fingerprint = 0;
+
         /** Guide. */
         double guide = 0;
 
-        /** Next child to generate. */
+        /**
+         * Next child to generate.
+         *
+         * If 'canonical' is set, position of the item in 'sorted_items_'.
+         */
         ItemPos next_child_pos = 0;
 
         /** Unique id of the node. */
@@ -86,14 +136,68 @@ public:
             const Instance& instance,
             const Parameters& parameters):
         instance_(instance),
-        parameters_(parameters) { }
+        parameters_(parameters),
+        number_of_words_((instance.number_of_items() + word_size - 1) / word_size)
+    {
+        // Initialize sorted_items_.
+        sorted_items_.resize(instance_.number_of_items());
+        for (ItemId item_id = 0;
+                item_id < instance_.number_of_items();
+                ++item_id) {
+            sorted_items_[item_id] = item_id;
+        }
+        std::stable_sort(
+                sorted_items_.begin(),
+                sorted_items_.end(),
+                [&instance](ItemId item_id_1, ItemId item_id_2) -> bool
+                {
+                    const Item& item_1 = instance.item(item_id_1);
+                    const Item& item_2 = instance.item(item_id_2);
+                    return item_1.profit * item_2.weight
+                        > item_2.profit * item_1.weight;
+                });
+
+        // Initialize item_keys_.
+        std::mt19937_64 generator(0);
+        item_keys_.resize(instance_.number_of_items());
+        for (ItemId item_id = 0;
+                item_id < instance_.number_of_items();
+                ++item_id) {
+            item_keys_[item_id] = generator();
+        }
+
+        // Initialize removed_items_.
+        // In canonical mode, the row of an item also contains the items
+        // ranked before it.
+        removed_items_.resize(instance_.number_of_items() * number_of_words_, 0);
+        std::vector<Word> previous_items(number_of_words_, 0);
+        for (ItemPos item_pos = 0;
+                item_pos < instance_.number_of_items();
+                ++item_pos) {
+            ItemId item_id = sorted_items_[item_pos];
+            Word* removed_items = &removed_items_[item_id * number_of_words_];
+            if (parameters_.canonical) {
+                for (WordPos word_pos = 0; word_pos < number_of_words_; ++word_pos)
+                    removed_items[word_pos] = previous_items[word_pos];
+                previous_items[item_id / word_size] |= (Word)1 << (item_id % word_size);
+            }
+            removed_items[item_id / word_size] |= (Word)1 << (item_id % word_size);
+            for (ItemId item_id_2: instance_.item(item_id).neighbors)
+                removed_items[item_id_2 / word_size] |= (Word)1 << (item_id_2 % word_size);
+        }
+    }
 
     inline const std::shared_ptr<Node> root() const
     {
         auto r = std::shared_ptr<Node>(new BranchingScheme::Node());
         r->node_id = node_id_;
         node_id_++;
-        r->available_items.resize(instance_.number_of_items(), true);
+        r->available_items.resize(number_of_words_, 0);
+        for (ItemId item_id = 0;
+                item_id < instance_.number_of_items();
+                ++item_id) {
+            r->available_items[item_id / word_size] |= (Word)1 << (item_id % word_size);
+        }
         r->number_of_remaining_items = instance_.number_of_items();
         for (ItemId item_id = 0;
                 item_id < instance_.number_of_items();
@@ -101,6 +205,7 @@ public:
             r->remaining_weight += instance_.item(item_id).weight;
             r->remaining_profit += instance_.item(item_id).profit;
         }
+        r->upper_bound = compute_upper_bound(*r);
         return r;
     }
 
@@ -108,13 +213,22 @@ public:
             const std::shared_ptr<Node>& parent) const
     {
         // Get the next item to add.
-        ItemId item_id_next = parent->next_child_pos;
+        ItemId item_id_next = (parameters_.canonical)?
+            sorted_items_[parent->next_child_pos]:
+            parent->next_child_pos;
 
         // Update parent
         parent->next_child_pos++;
+        if (parameters_.canonical) {
+            // Skip the items which are not available anymore.
+            while (parent->next_child_pos < instance_.number_of_items()
+                    && !is_available(*parent, sorted_items_[parent->next_child_pos])) {
+                parent->next_child_pos++;
+            }
+        }
 
         // Check if the item is still available.
-        if (!parent->available_items[item_id_next])
+        if (!is_available(*parent, item_id_next))
             return nullptr;
 
         // Check if the item fit in the knapsack.
@@ -128,21 +242,39 @@ public:
         child->parent = parent;
         child->item_id = item_id_next;
         child->number_of_items = parent->number_of_items + 1;
-        child->available_items = parent->available_items;
-        child->available_items[item_id_next] = false;
-        child->number_of_remaining_items = parent->number_of_remaining_items - 1;
-        child->remaining_weight = parent->remaining_weight - instance_.item(item_id_next).weight;
-        child->remaining_profit = parent->remaining_profit - instance_.item(item_id_next).profit;
-        for (ItemId item_id: instance_.item(item_id_next).neighbors) {
-            if (child->available_items[item_id]) {
-                child->available_items[item_id] = false;
+        child->available_items.resize(number_of_words_);
+        child->number_of_remaining_items = parent->number_of_remaining_items;
+        child->remaining_weight = parent->remaining_weight;
+        child->remaining_profit = parent->remaining_profit;
+        const Word* parent_available_items = parent->available_items.data();
+        const Word* removed_items = &removed_items_[item_id_next * number_of_words_];
+        Word* child_available_items = child->available_items.data();
+        for (WordPos word_pos = 0; word_pos < number_of_words_; ++word_pos)
+            child_available_items[word_pos] = parent_available_items[word_pos] & ~removed_items[word_pos];
+        // Remove the items which were available and are not anymore.
+        for (WordPos word_pos = 0; word_pos < number_of_words_; ++word_pos) {
+            Word word = parent_available_items[word_pos] & removed_items[word_pos];
+            while (word != 0) {
+                ItemId item_id = word_pos * word_size + count_trailing_zeros(word);
                 child->number_of_remaining_items--;
                 child->remaining_weight -= instance_.item(item_id).weight;
                 child->remaining_profit -= instance_.item(item_id).profit;
+                word &= word - 1;
             }
         }
         child->weight = parent->weight + instance_.item(item_id_next).weight;
         child->profit = parent->profit + instance_.item(item_id_next).profit;
+        child->fingerprint = parent->fingerprint ^ item_keys_[item_id_next];
+        if (parameters_.canonical) {
+            // The items ranked before the new item are not available
+            // anymore.
+            child->next_child_pos = parent->next_child_pos;
+            while (child->next_child_pos < instance_.number_of_items()
+                    && !is_available(*child, sorted_items_[child->next_child_pos])) {
+                child->next_child_pos++;
+            }
+        }
+        child->upper_bound = compute_upper_bound(*child);
         child->guide =
             (parameters_.guide_id == 0)? (double)child->weight / child->profit:
             (parameters_.guide_id == 1)? (double)child->weight / child->profit / child->remaining_profit:
@@ -177,7 +309,7 @@ public:
             const std::shared_ptr<Node>& node_1,
             const std::shared_ptr<Node>& node_2) const
     {
-        return node_1->profit + node_1->remaining_profit <= node_2->profit;
+        return node_1->upper_bound <= node_2->profit;
     }
 
     /*
@@ -207,12 +339,18 @@ public:
         std::vector<bool> v(instance_.number_of_items(), false);
         for (auto node_tmp = node_1; node_tmp->parent != nullptr; node_tmp = node_tmp->parent)
             v[node_tmp->item_id] = true;
-        for (auto node_tmp = node_1; node_tmp->parent != nullptr; node_tmp = node_tmp->parent)
+        for (auto node_tmp = node_2; node_tmp->parent != nullptr; node_tmp = node_tmp->parent)
             if (!v[node_tmp->item_id])
                 return false;
         return true;
     }
 
+    inline uint64_t fingerprint(
+            const std::shared_ptr<Node>& node) const
+    {
+        return node->fingerprint;
+    }
+
     std::string display(const std::shared_ptr<Node>& node) const
     {
         std::stringstream ss;
@@ -223,6 +361,11 @@ public:
         return ss.str();
     }
 
+    double value(const std::shared_ptr<Node>& node) const
+    {
+        return node->profit;
+    }
+
     /*
      * Dominances.
      */
@@ -235,8 +378,6 @@ public:
 
     struct NodeHasher
     {
-        std::hash<std::vector<bool>> hasher;
-
         inline bool operator()(
                 const std::shared_ptr<Node>& node_1,
                 const std::shared_ptr<Node>& node_2) const
@@ -247,7 +388,9 @@ public:
         inline std::size_t operator()(
                 const std::shared_ptr<Node>& node) const
         {
-            size_t hash = hasher(node->available_items);
+            size_t hash = 0;
+            for (Word word: node->available_items)
+                optimizationtools::hash_combine(hash, word);
             return hash;
         }
     };
@@ -328,27 +471,141 @@ public:
             throw std::runtime_error(
                     "Unable to open file \"" + certificate_path + "\".");
         }
+        solution_write(node, file);
+    }
 
+    inline void solution_write(
+            const std::shared_ptr<Node>& node,
+            std::ostream& os) const
+    {
         std::vector<ItemId> items;
         for (auto node_tmp = node; node_tmp->parent != nullptr;
                 node_tmp = node_tmp->parent)
             items.push_back(node_tmp->item_id);
         std::reverse(items.begin(), items.end());
         for (ItemId item_id: items)
-            file << item_id << " ";
+            os << item_id << " ";
     }
 
 private:
 
+    /** Number of items per word of the bitsets. */
+    static const ItemId word_size = 64;
+
+    /** Get the index of the lowest set bit of a non-zero word. */
+    static inline ItemId count_trailing_zeros(Word word)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctzll(word);
+#else
+        ItemId pos = 0;
+        while (!((word >> pos) & 1))
+            pos++;
+        return pos;
+#endif
+    }
+
+    /** Check if an item is available in a node. */
+    inline bool is_available(
+            const Node& node,
+            ItemId item_id) const
+    {
+        return (node.available_items[item_id / word_size]
+                >> (item_id % word_size)) & 1;
+    }
+
+    /** Compute the upper bound of a node. */
+    inline Profit compute_upper_bound(
+            const Node& node) const
+    {
+        if (parameters_.bound_id == 0)
+            return node.profit + node.remaining_profit;
+
+        // Fractional relaxation on the available items.
+        Profit upper_bound = node.profit;
+        Weight remaining_capacity = instance_.capacity() - node.weight;
+        ItemPos item_pos_start = (parameters_.canonical)?
+            node.next_child_pos: 0;
+        for (ItemPos item_pos = item_pos_start;
+                item_pos < instance_.number_of_items()
+                && remaining_capacity > 0;
+                ++item_pos) {
+            ItemId item_id = sorted_items_[item_pos];
+            if (!is_available(node, item_id))
+                continue;
+            const Item& item = instance_.item(item_id);
+            if (item.weight <= remaining_capacity) {
+                upper_bound += item.profit;
+                remaining_capacity -= item.weight;
+            } else {
+                upper_bound += item.profit * remaining_capacity / item.weight;
+                remaining_capacity = 0;
+            }
+        }
+        return upper_bound;
+    }
+
     /** Instance. */
     const Instance& instance_;
 
     /** Parameters. */
     Parameters parameters_;
 
+    /** Random key of each item, used to compute the fingerprints. */
+    std::vector<uint64_t> item_keys_;
+
+    /** Items sorted by non-increasing efficiency. */
+    std::vector<ItemId> sorted_items_;
+
+    /** Number of words of the bitsets. */
+    WordPos number_of_words_;
+
+    /**
+     * For each item, bitset of the item, of its conflicting items and, in
+     * canonical mode, of the items ranked before it: words
+     * 'j * number_of_words_' to '(j + 1) * number_of_words_ - 1' for item
+     * 'j'.
+     */
+    std::vector<Word> removed_items_;
+
     mutable NodeId node_id_ = 0;
 
 };
 
+
+/**
+ * Generate a random instance.
+ *
+ * Weights and profits are drawn uniformly in [1, 100], the capacity is a
+ * fraction of the total weight, and each pair of items is in conflict with
+ * probability 'conflict_density'.
+ */
+inline Instance generate_instance(
+        ItemId number_of_items,
+        double conflict_density,
+        double capacity_ratio = 0.25,
+        uint64_t seed = 0)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<Weight> d_weight(1, 100);
+    std::uniform_int_distribution<Profit> d_profit(1, 100);
+    std::bernoulli_distribution d_conflict(conflict_density);
+
+    InstanceBuilder instance_builder;
+    Weight weight_sum = 0;
+    for (ItemId item_id = 0; item_id < number_of_items; ++item_id) {
+        Weight weight = d_weight(generator);
+        Profit profit = d_profit(generator);
+        instance_builder.add_item(weight, profit);
+        weight_sum += weight;
+    }
+    instance_builder.set_capacity((Weight)(capacity_ratio * weight_sum));
+    for (ItemId item_id_1 = 0; item_id_1 < number_of_items; ++item_id_1)
+        for (ItemId item_id_2 = item_id_1 + 1; item_id_2 < number_of_items; ++item_id_2)
+            if (d_conflict(generator))
+                instance_builder.add_conflict(item_id_1, item_id_2);
+    return instance_builder.build();
+}
+
 }
 }
@@ -0,0 +1,67 @@
+/**
+ * Permutation flow shop scheduling problem, instance generator
+ *
+ * Generator of Taillard (1993), "Benchmarks for basic scheduling problems",
+ * shared by the makespan and the total completion time examples.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace treesearchsolver
+{
+namespace permutation_flowshop_scheduling
+{
+
+/**
+ * Random number generator of Taillard (1993).
+ *
+ * Returns an integer uniformly drawn in [low, high] and updates the seed.
+ */
+inline int64_t taillard_unif(
+        int64_t& seed,
+        int64_t low,
+        int64_t high)
+{
+    const int64_t m = 2147483647;
+    const int64_t a = 16807;
+    const int64_t b = 127773;
+    const int64_t c = 2836;
+    int64_t k = seed / b;
+    seed = a * (seed % b) - k * c;
+    if (seed < 0)
+        seed += m;
+    double value_0_1 = (double)seed / m;
+    return low + (int64_t)(value_0_1 * (high - low + 1));
+}
+
+/**
+ * Generate a random instance with the generator of Taillard (1993).
+ *
+ * Processing times are drawn uniformly in [1, 99], machine by machine. With
+ * the time seed 873654221 of the paper and 20 jobs on 5 machines, this
+ * reproduces ta001; the other instances of the paper have not been checked.
+ */
+template <typename Instance, typename InstanceBuilder>
+inline Instance generate_instance(
+        int64_t number_of_jobs,
+        int64_t number_of_machines,
+        int64_t seed)
+{
+    InstanceBuilder instance_builder;
+    instance_builder.set_number_of_machines(number_of_machines);
+    instance_builder.add_jobs(number_of_jobs);
+    for (int64_t machine_id = 0; machine_id < number_of_machines; ++machine_id) {
+        for (int64_t job_id = 0; job_id < number_of_jobs; ++job_id) {
+            instance_builder.set_processing_time(
+                    job_id,
+                    machine_id,
+                    taillard_unif(seed, 1, 99));
+        }
+    }
+    return instance_builder.build();
+}
+
+}
+}
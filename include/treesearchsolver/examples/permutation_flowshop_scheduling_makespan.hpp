@@ -12,13 +12,33 @@
  *   - 2: weighted idle time
  *   - 3: bound and weighted idle time
  *   - 4: gap, bound and weighted idle time
+ * - Bounds:
+ *   - 0: one-machine bound
+ *   - 1: one-machine bound and two-machine bounds on consecutive machines
+ *   - 2: one-machine bound and two-machine bounds with time lags on all
+ *     pairs of machines
+ * - Dominance (optional): a node dominates another node with the same
+ *   remaining jobs if its forward and backward times are smaller on all
+ *   machines
+ *
+ * The two-machine bounds solve, for a pair of machines (k, l), the two-machine
+ * flow shop with time lags obtained by relaxing the capacity of the machines
+ * between k and l. This relaxation is solved by Johnson's rule applied to the
+ * processing times plus the lags (Mitten, 1959).
+ * "A Branch and Bound Algorithm for the Permutation Flow Shop Problem"
+ * (Lageweg et al., 1978)
  */
 
 #pragma once
 
+#include "treesearchsolver/examples/permutation_flowshop_scheduling_generator.hpp"
+
 #include "orproblems/scheduling/permutation_flowshop_scheduling_makespan.hpp"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <random>
 #include <sstream>
 
 namespace treesearchsolver
@@ -30,6 +50,7 @@ using namespace orproblems::permutation_flowshop_scheduling_makespan;
 
 using NodeId = int64_t;
 using GuideId = int64_t;
+using BoundId = int64_t;
 
 class BranchingSchemeBidirectional
 {
@@ -45,6 +66,13 @@ public:
         Time idle_time_backward = 0;
     };
 
+    struct NodeChild
+    {
+        Time bound;
+        Time idle_time;
+        double weighted_idle_time;
+    };
+
     struct Node
     {
         /** Parent node. */
@@ -53,6 +81,12 @@ public:
         /** Array indicating for each job, if it still available. */
         std::vector<bool> available_jobs;
 
+        /**
+         * Hash of the set of available jobs, updated incrementally so that
+         * the hasher doesn't require the structures of the node.
+         */
+        uint64_t available_jobs_hash = 0;
+
         /** Position of the last job added in the solution. */
         bool forward = true;
 
@@ -65,6 +99,9 @@ public:
         /** Machines. */
         std::vector<NodeMachine> machines;
 
+        /** Sum of the forward and backward times of the machines. */
+        Time sum_of_times = 0;
+
         /** Idle time. */
         Time idle_time = 0;
 
@@ -80,6 +117,18 @@ public:
         /** Next child to generate. */
         JobId next_child_pos = 0;
 
+        /** Position of the next child among the available jobs. */
+        JobPos next_child_available_pos = 0;
+
+        /**
+         * Children in the chosen direction, indexed by their position among
+         * the available jobs.
+         *
+         * They are computed all at once when choosing the direction and freed
+         * once the node is infertile.
+         */
+        std::vector<NodeChild> children;
+
         /** Unique id of the node. */
         NodeId node_id = -1;
     };
@@ -91,6 +140,12 @@ public:
 
         /** Guide. */
         GuideId guide_id = 3;
+
+        /** Bound. */
+        BoundId bound_id = 0;
+
+        /** Enable dominance. */
+        bool dominance = false;
     };
 
     BranchingSchemeBidirectional(
@@ -99,6 +154,76 @@ public:
         instance_(instance),
         parameters_(parameters)
     {
+        MachineId m = instance_.number_of_machines();
+        JobId n = instance_.number_of_jobs();
+        processing_times_.resize(m * n);
+        for (MachineId machine_id = 0; machine_id < m; ++machine_id)
+            for (JobId job_id = 0; job_id < n; ++job_id)
+                processing_times_[machine_id * n + job_id] = instance_.processing_time(job_id, machine_id);
+
+        // Random values of the jobs, whose xor over the available jobs is the
+        // hash of a node.
+        std::mt19937_64 generator(0);
+        job_hashes_.resize(n);
+        for (JobId job_id = 0; job_id < n; ++job_id)
+            job_hashes_[job_id] = generator();
+        block_processing_times_.resize(m * number_of_lanes);
+
+        // Machine pairs of the two-machine bounds.
+        if (parameters_.bound_id == 1) {
+            for (MachineId machine_id = 0; machine_id < m - 1; ++machine_id)
+                machine_pairs_.push_back({machine_id, machine_id + 1});
+        } else if (parameters_.bound_id == 2) {
+            for (MachineId machine_id_1 = 0; machine_id_1 < m; ++machine_id_1)
+                for (MachineId machine_id_2 = machine_id_1 + 1; machine_id_2 < m; ++machine_id_2)
+                    machine_pairs_.push_back({machine_id_1, machine_id_2});
+        }
+
+        // Lags and Johnson orders of the machine pairs.
+        MachinePairId number_of_machine_pairs = machine_pairs_.size();
+        lags_.resize(number_of_machine_pairs * n, 0);
+        johnson_orders_.resize(number_of_machine_pairs * n);
+        for (MachinePairId pair_id = 0; pair_id < number_of_machine_pairs; ++pair_id) {
+            const MachinePair& pair = machine_pairs_[pair_id];
+            Time* lags = &lags_[pair_id * n];
+            for (MachineId machine_id = pair.machine_id_1 + 1;
+                    machine_id < pair.machine_id_2;
+                    ++machine_id) {
+                for (JobId job_id = 0; job_id < n; ++job_id)
+                    lags[job_id] += processing_times_[machine_id * n + job_id];
+            }
+            const Time* processing_times_1 = &processing_times_[pair.machine_id_1 * n];
+            const Time* processing_times_2 = &processing_times_[pair.machine_id_2 * n];
+            JobId* order = &johnson_orders_[pair_id * n];
+            for (JobId job_id = 0; job_id < n; ++job_id)
+                order[job_id] = job_id;
+            // Johnson's rule: first the jobs shorter on the first machine by
+            // non-decreasing first times, then the other jobs by
+            // non-increasing second times.
+            std::stable_sort(
+                    order,
+                    order + n,
+                    [processing_times_1, processing_times_2, lags](
+                        JobId job_id_1,
+                        JobId job_id_2)
+                    {
+                        Time a1 = processing_times_1[job_id_1] + lags[job_id_1];
+                        Time b1 = processing_times_2[job_id_1] + lags[job_id_1];
+                        Time a2 = processing_times_1[job_id_2] + lags[job_id_2];
+                        Time b2 = processing_times_2[job_id_2] + lags[job_id_2];
+                        bool first_1 = (a1 < b1);
+                        bool first_2 = (a2 < b2);
+                        if (first_1 != first_2)
+                            return first_1;
+                        if (first_1)
+                            return a1 < a2;
+                        return b1 > b2;
+                    });
+        }
+        if (number_of_machine_pairs > 0) {
+            block_times_forward_.resize(m * number_of_lanes);
+            block_times_backward_.resize(m * number_of_lanes);
+        }
     }
 
     inline const std::shared_ptr<Node> root() const
@@ -109,16 +234,18 @@ public:
         r->node_id = node_id_;
         node_id_++;
         r->available_jobs.resize(n, true);
+        for (JobId job_id = 0; job_id < n; ++job_id)
+            r->available_jobs_hash ^= job_hashes_[job_id];
         r->machines.resize(m);
         for (JobId job_id = 0; job_id < n; ++job_id) {
             for (MachineId machine_id = 0; machine_id < m; ++machine_id) {
                 r->machines[machine_id].remaining_processing_time
-                    += instance_.processing_time(job_id, machine_id);
+                    += processing_times_[machine_id * n + job_id];
             }
         }
         r->bound = 0;
         for (JobId job_id = 0; job_id < n; ++job_id)
-            r->bound += instance_.processing_time(job_id, m - 1);
+            r->bound += processing_times_[(m - 1) * n + job_id];
         if (best_node_ == nullptr)
             best_node_ = r;
         return r;
@@ -128,15 +255,16 @@ public:
             const std::shared_ptr<Node>& node) const
     {
         MachineId m = instance_.number_of_machines();
+        JobId n = instance_.number_of_jobs();
         auto parent = node->parent;
         node->available_jobs = parent->available_jobs;
         node->available_jobs[node->job_id] = false;
         node->machines = parent->machines;
         if (parent->forward) {
             node->machines[0].time_forward
-                += instance_.processing_time(node->job_id, 0);
+                += processing_times_[node->job_id];
             node->machines[0].remaining_processing_time
-                -= instance_.processing_time(node->job_id, 0);
+                -= processing_times_[node->job_id];
             for (MachineId machine_id = 1; machine_id < m; ++machine_id) {
                 if (node->machines[machine_id - 1].time_forward
                         > parent->machines[machine_id].time_forward) {
@@ -144,18 +272,18 @@ public:
                         - parent->machines[machine_id].time_forward;
                     node->machines[machine_id].time_forward
                         = node->machines[machine_id - 1].time_forward
-                        + instance_.processing_time(node->job_id, machine_id);
+                        + processing_times_[machine_id * n + node->job_id];
                     node->machines[machine_id].idle_time_forward += idle_time;
                 } else {
                     node->machines[machine_id].time_forward
-                        += instance_.processing_time(node->job_id, machine_id);
+                        += processing_times_[machine_id * n + node->job_id];
                 }
                 node->machines[machine_id].remaining_processing_time
-                    -= instance_.processing_time(node->job_id, machine_id);
+                    -= processing_times_[machine_id * n + node->job_id];
             }
         } else {
-            node->machines[m - 1].time_backward += instance_.processing_time(node->job_id, m - 1);
-            node->machines[m - 1].remaining_processing_time -= instance_.processing_time(node->job_id, m - 1);
+            node->machines[m - 1].time_backward += processing_times_[(m - 1) * n + node->job_id];
+            node->machines[m - 1].remaining_processing_time -= processing_times_[(m - 1) * n + node->job_id];
             for (MachineId machine_id = m - 2; machine_id >= 0; --machine_id) {
                 if (node->machines[machine_id + 1].time_backward
                         > parent->machines[machine_id].time_backward) {
@@ -163,25 +291,38 @@ public:
                         - parent->machines[machine_id].time_backward;
                     node->machines[machine_id].time_backward
                         = node->machines[machine_id + 1].time_backward
-                        + instance_.processing_time(node->job_id, machine_id);
+                        + processing_times_[machine_id * n + node->job_id];
                     node->machines[machine_id].idle_time_backward += idle_time;
                 } else {
                     node->machines[machine_id].time_backward
-                        += instance_.processing_time(node->job_id, machine_id);
+                        += processing_times_[machine_id * n + node->job_id];
                 }
                 node->machines[machine_id].remaining_processing_time
-                    -= instance_.processing_time(node->job_id, machine_id);
+                    -= processing_times_[machine_id * n + node->job_id];
             }
         }
+        node->sum_of_times = 0;
+        for (MachineId machine_id = 0; machine_id < m; ++machine_id) {
+            node->sum_of_times += node->machines[machine_id].time_forward
+                + node->machines[machine_id].time_backward;
+        }
+    }
+
+    /** Compute the structures of a node if they have not been computed. */
+    inline void compute_structures_if_needed(
+            const std::shared_ptr<Node>& node) const
+    {
+        if (node->machines.empty())
+            compute_structures(node);
     }
 
     inline std::shared_ptr<Node> next_child(
             const std::shared_ptr<Node>& parent) const
     {
 
-        // Compute parent's structures.
-        if (parent->next_child_pos == 0 && parent->parent != nullptr)
-            compute_structures(parent);
+        // Compute parent's structures and its children.
+        if (parent->next_child_pos == 0)
+            compute_children(parent);
 
         //if (parent->next_child_pos == 0)
         //    std::cout << "parent"
@@ -193,97 +334,6 @@ public:
         //        << " guide " << parent->guide
         //        << std::endl;
 
-        // Determine wether to use forward or backward.
-        if (parent->next_child_pos != 0) {
-        } else if (!parameters_.bidirectional) {
-            parent->forward = true;
-        } else if (parent->parent == nullptr) {
-            parent->forward = true;
-        } else if (parent->parent->parent == nullptr) {
-            parent->forward = false;
-        } else {
-            MachineId m = instance_.number_of_machines();
-            JobId n = instance_.number_of_jobs();
-            JobPos n_forward = 0;
-            JobPos n_backward = 0;
-            Time bound_forward = 0;
-            Time bound_backward = 0;
-            for (JobId job_id_next = 0; job_id_next < n; ++job_id_next) {
-                if (!parent->available_jobs[job_id_next])
-                    continue;
-                // Forward.
-                Time bf = 0;
-                Time t_prec = parent->machines[0].time_forward
-                    + instance_.processing_time(job_id_next, 0);
-                Time t = 0;
-                bf = std::max(bf,
-                        t_prec
-                        + parent->machines[0].remaining_processing_time
-                        - instance_.processing_time(job_id_next, 0)
-                        + parent->machines[0].time_backward);
-                for (MachineId machine_id = 1; machine_id < m; ++machine_id) {
-                    if (t_prec > parent->machines[machine_id].time_forward) {
-                        t = t_prec + instance_.processing_time(job_id_next, machine_id);
-                    } else {
-                        t = parent->machines[machine_id].time_forward
-                            + instance_.processing_time(job_id_next, machine_id);
-                    }
-                    bf = std::max(
-                            bf,
-                            t + parent->machines[machine_id].remaining_processing_time
-                            - instance_.processing_time(job_id_next, machine_id)
-                            + parent->machines[machine_id].time_backward);
-                    t_prec = t;
-                }
-                if (best_node_->number_of_jobs != n
-                        || bf < best_node_->bound) {
-                    n_forward++;
-                    bound_forward += bf;
-                }
-                // Backward.
-                Time bb = 0;
-                t_prec
-                    = parent->machines[m - 1].time_backward
-                    + instance_.processing_time(job_id_next, m - 1);
-                bb = std::max(bb,
-                        parent->machines[m - 1].time_forward
-                        + parent->machines[m - 1].remaining_processing_time
-                        - instance_.processing_time(job_id_next, m - 1)
-                        + t_prec);
-                for (MachineId machine_id = m - 2; machine_id >= 0; --machine_id) {
-                    if (t_prec > parent->machines[machine_id].time_backward) {
-                        t = t_prec + instance_.processing_time(job_id_next, machine_id);
-                    } else {
-                        t = parent->machines[machine_id].time_backward
-                            + instance_.processing_time(job_id_next, machine_id);
-                    }
-                    bb = std::max(
-                            bb,
-                            parent->machines[machine_id].time_forward
-                            + parent->machines[machine_id].remaining_processing_time
-                            - instance_.processing_time(job_id_next, machine_id)
-                            + t);
-                    t_prec = t;
-                }
-                if (best_node_->number_of_jobs != n
-                        || bb < best_node_->bound) {
-                    n_backward++;
-                    bound_backward += bb;
-                }
-            }
-            if (n_forward < n_backward) {
-                parent->forward = true;
-            } else if (n_forward > n_backward) {
-                parent->forward = false;
-            } else if (bound_forward > bound_backward) {
-                parent->forward = true;
-            } else if (bound_forward < bound_backward) {
-                parent->forward = false;
-            } else {
-                parent->forward = !parent->parent->forward;
-            }
-        }
-
         // Get the next job to process.
         JobId job_id_next = parent->next_child_pos;
 
@@ -291,130 +341,51 @@ public:
         parent->next_child_pos++;
 
         // Check job availibility.
-        if (!parent->available_jobs[job_id_next])
+        if (!parent->available_jobs[job_id_next]) {
+            free_children(parent);
             return nullptr;
+        }
+        JobPos pos = parent->next_child_available_pos;
+        parent->next_child_available_pos++;
+
+        auto child = create_child(parent, job_id_next, pos);
+        free_children(parent);
+        return child;
+    }
+
+    /**
+     * Generate all the remaining children of a node.
+     *
+     * The children are the same as the ones generated by successive calls to
+     * 'next_child'.
+     */
+    inline std::vector<std::shared_ptr<Node>> children(
+            const std::shared_ptr<Node>& parent) const
+    {
+        // The children of an infertile node have already been generated, and
+        // its buffered children freed.
+        if (infertile(parent))
+            return {};
+
+        // Compute parent's structures and its children.
+        if (parent->next_child_pos == 0)
+            compute_children(parent);
 
-        // Compute new child.
-        MachineId m = instance_.number_of_machines();
         JobId n = instance_.number_of_jobs();
-        auto child = std::shared_ptr<Node>(new BranchingSchemeBidirectional::Node());
-        child->node_id = node_id_;
-        node_id_++;
-        child->parent = parent;
-        child->job_id = job_id_next;
-        child->number_of_jobs = parent->number_of_jobs + 1;
-        // Update machines and idle_time.
-        child->idle_time = parent->idle_time;
-        Time t = 0;
-        Time t_prec = 0;
-        if (parent->forward) {
-            t_prec = parent->machines[0].time_forward
-                + instance_.processing_time(job_id_next, 0);
-            Time remaining_processing_time
-                = parent->machines[0].remaining_processing_time
-                - instance_.processing_time(job_id_next, 0);
-            child->weighted_idle_time += (parent->machines[0].time_backward == 0)? 1:
-                (double)parent->machines[0].idle_time_backward / parent->machines[0].time_backward;
-            child->bound = std::max(child->bound,
-                    t_prec
-                    + remaining_processing_time
-                    + parent->machines[0].time_backward);
-            for (MachineId machine_id = 1; machine_id < m; ++machine_id) {
-                Time machine_idle_time = parent->machines[machine_id].idle_time_forward;
-                if (t_prec > parent->machines[machine_id].time_forward) {
-                    Time idle_time = t_prec - parent->machines[machine_id].time_forward;
-                    t = t_prec + instance_.processing_time(job_id_next, machine_id);
-                    machine_idle_time += idle_time;
-                    child->idle_time += idle_time;
-                } else {
-                    t = parent->machines[machine_id].time_forward
-                        + instance_.processing_time(job_id_next, machine_id);
-                }
-                Time remaining_processing_time
-                    = parent->machines[machine_id].remaining_processing_time
-                    - instance_.processing_time(job_id_next, machine_id);
-                child->weighted_idle_time += (t == 0)? 1:
-                    (double)machine_idle_time / t;
-                child->weighted_idle_time += (parent->machines[machine_id].time_backward == 0)? 1:
-                    (double)parent->machines[machine_id].idle_time_backward
-                    / parent->machines[machine_id].time_backward;
-                child->bound = std::max(
-                        child->bound,
-                        t + remaining_processing_time
-                        + parent->machines[machine_id].time_backward);
-                t_prec = t;
-            }
-        } else {
-            t_prec = parent->machines[m - 1].time_backward
-                + instance_.processing_time(job_id_next, m - 1);
-            Time remaining_processing_time
-                = parent->machines[m - 1].remaining_processing_time
-                - instance_.processing_time(job_id_next, m - 1);
-            child->weighted_idle_time += (parent->machines[m - 1].time_forward == 0)? 1:
-                (double)parent->machines[m - 1].idle_time_forward / parent->machines[m - 1].time_forward;
-            child->bound = std::max(child->bound,
-                    parent->machines[m - 1].time_forward
-                    + remaining_processing_time
-                    + t_prec);
-            for (MachineId machine_id = m - 2; machine_id >= 0; --machine_id) {
-                Time machine_idle_time = parent->machines[machine_id].idle_time_backward;
-                if (t_prec > parent->machines[machine_id].time_backward) {
-                    Time idle_time = t_prec - parent->machines[machine_id].time_backward;
-                    t = t_prec + instance_.processing_time(job_id_next, machine_id);
-                    machine_idle_time += idle_time;
-                    child->idle_time += idle_time;
-                } else {
-                    t = parent->machines[machine_id].time_backward
-                        + instance_.processing_time(job_id_next, machine_id);
-                }
-                Time remaining_processing_time
-                    = parent->machines[machine_id].remaining_processing_time
-                    - instance_.processing_time(job_id_next, machine_id);
-                child->weighted_idle_time += (parent->machines[machine_id].time_forward == 0)? 1:
-                    (double)parent->machines[machine_id].idle_time_forward
-                    / parent->machines[machine_id].time_forward;
-                child->weighted_idle_time += (t == 0)? 1:
-                    (double)machine_idle_time / t;
-                child->bound = std::max(
-                        child->bound,
-                        parent->machines[machine_id].time_forward
-                        + remaining_processing_time + t);
-                t_prec = t;
-            }
+        std::vector<std::shared_ptr<Node>> c;
+        c.reserve(parent->children.size() - parent->next_child_available_pos);
+        for (JobId job_id = parent->next_child_pos; job_id < n; ++job_id) {
+            if (!parent->available_jobs[job_id])
+                continue;
+            c.push_back(create_child(
+                        parent,
+                        job_id,
+                        parent->next_child_available_pos));
+            parent->next_child_available_pos++;
         }
-        // Compute guide.
-        double alpha = (double)child->number_of_jobs / n;
-        switch (parameters_.guide_id) {
-        case 0: {
-            child->guide = child->bound;
-            break;
-        } case 1: {
-            child->guide = child->idle_time;
-            break;
-        } case 2: {
-            child->guide = alpha * child->bound
-                + (1.0 - alpha) * child->idle_time * child->number_of_jobs / m;
-            break;
-        } case 3: {
-            child->guide = alpha * child->bound
-                + (1.0 - alpha) * child->weighted_idle_time * child->bound;
-            break;
-        } case 4: {
-            double a1 = (best_node_->number_of_jobs == instance_.number_of_jobs())?
-                (double)(best_node_->bound) / (best_node_->bound - child->bound):
-                1 - alpha;
-            double a2 = (best_node_->number_of_jobs == instance_.number_of_jobs())?
-                (double)(best_node_->bound - child->bound) / best_node_->bound:
-                alpha;
-            child->guide = a1 * child->bound
-                + a2 * child->weighted_idle_time;
-            break;
-        } default: {
-        }
-        }
-        if (better(child, best_node_))
-            best_node_ = child;
-        return child;
+        parent->next_child_pos = n;
+        free_children(parent);
+        return c;
     }
 
     inline bool infertile(
@@ -483,7 +454,9 @@ public:
             const std::shared_ptr<Node>& node) const
     {
         (void)node;
-        return false;
+        // The structures of the nodes are only computed when they are
+        // compared, that is, when another node has the same available jobs.
+        return parameters_.dominance;
     }
 
     const Instance& instance() const { return instance_; }
@@ -491,7 +464,6 @@ public:
     struct NodeHasher
     {
         const BranchingSchemeBidirectional& branching_scheme_;
-        std::hash<std::vector<bool>> hasher;
 
         NodeHasher(const BranchingSchemeBidirectional& branching_scheme):
             branching_scheme_(branching_scheme) { }
@@ -500,6 +472,12 @@ public:
                 const std::shared_ptr<Node>& node_1,
                 const std::shared_ptr<Node>& node_2) const
         {
+            if (node_1 == node_2)
+                return true;
+            if (node_1->available_jobs_hash != node_2->available_jobs_hash)
+                return false;
+            branching_scheme_.compute_structures_if_needed(node_1);
+            branching_scheme_.compute_structures_if_needed(node_2);
             if (node_1->available_jobs != node_2->available_jobs)
                 return false;
             return true;
@@ -508,8 +486,7 @@ public:
         inline std::size_t operator()(
                 const std::shared_ptr<Node>& node) const
         {
-            size_t hash = hasher(node->available_jobs);
-            return hash;
+            return node->available_jobs_hash;
         }
     };
 
@@ -519,9 +496,30 @@ public:
             const std::shared_ptr<Node>& node_1,
             const std::shared_ptr<Node>& node_2) const
     {
-        (void)node_1;
-        (void)node_2;
-        return false;
+        compute_structures_if_needed(node_1);
+        compute_structures_if_needed(node_2);
+        // The makespan of a solution is non-decreasing with the forward and
+        // backward times of its partial solutions, whichever jobs are
+        // scheduled at the front and at the back.
+        // Branch-free so that it can be vectorized.
+        MachineId m = instance_.number_of_machines();
+        const NodeMachine* machines_1 = node_1->machines.data();
+        const NodeMachine* machines_2 = node_2->machines.data();
+        bool dominates = true;
+        for (MachineId machine_id = 0; machine_id < m; ++machine_id) {
+            dominates &= (machines_1[machine_id].time_forward
+                    <= machines_2[machine_id].time_forward);
+            dominates &= (machines_1[machine_id].time_backward
+                    <= machines_2[machine_id].time_backward);
+        }
+        return dominates;
+    }
+
+    inline double dominance_key(
+            const std::shared_ptr<Node>& node) const
+    {
+        compute_structures_if_needed(node);
+        return node->sum_of_times;
     }
 
     /*
@@ -544,6 +542,13 @@ public:
         return ss.str();
     }
 
+    double value(const std::shared_ptr<Node>& node) const
+    {
+        if (node->number_of_jobs != instance_.number_of_jobs())
+            return std::numeric_limits<double>::quiet_NaN();
+        return node->bound;
+    }
+
     void solution_format(
             const std::shared_ptr<Node>& node,
             std::ostream& os,
@@ -571,7 +576,13 @@ public:
             throw std::runtime_error(
                     "Unable to open file \"" + certificate_path + "\".");
         }
+        solution_write(node, file);
+    }
 
+    inline void solution_write(
+            const std::shared_ptr<Node>& node,
+            std::ostream& os) const
+    {
         std::vector<JobId> jobs_forward;
         std::vector<JobId> jobs_backward;
         for (auto node_tmp = node;
@@ -586,18 +597,651 @@ public:
         std::reverse(jobs_forward.begin(), jobs_forward.end());
         jobs_forward.insert(jobs_forward.end(), jobs_backward.begin(), jobs_backward.end());
         for (JobId job_id: jobs_forward)
-            file << job_id << " ";
+            os << job_id << " ";
     }
 
 
 private:
 
+    /** Number of jobs processed together when choosing the direction. */
+    static const JobPos number_of_lanes = 8;
+
+    /**
+     * Gather the processing times of the jobs of a block in
+     * 'block_processing_times_'.
+     *
+     * The last block is padded with copies of its last job.
+     */
+    void gather_block(
+            JobPos block_start,
+            JobPos block_size) const
+    {
+        MachineId m = instance_.number_of_machines();
+        JobId n = instance_.number_of_jobs();
+        for (MachineId machine_id = 0; machine_id < m; ++machine_id) {
+            const Time* processing_times = &processing_times_[machine_id * n];
+            Time* block_processing_times = &block_processing_times_[machine_id * number_of_lanes];
+            for (JobPos lane = 0; lane < number_of_lanes; ++lane) {
+                JobId job_id = available_jobs_[block_start + (std::min)(lane, block_size - 1)];
+                block_processing_times[lane] = processing_times[job_id];
+            }
+        }
+    }
+
+    /**
+     * Compute the bounds of the children of a node in the forward and/or the
+     * backward directions.
+     *
+     * The available jobs are stored in 'available_jobs_' and the bounds in
+     * 'forward_bounds_' and 'backward_bounds_', indexed by the position of
+     * the jobs in 'available_jobs_'.
+     *
+     * The available jobs are processed by blocks of 'number_of_lanes' jobs.
+     * Within a block, the operations on the jobs have no dependencies and are
+     * branch-free, so that they can be vectorized.
+     */
+    void compute_bounds(
+            const std::shared_ptr<Node>& parent,
+            bool forward,
+            bool backward) const
+    {
+        MachineId m = instance_.number_of_machines();
+        JobId n = instance_.number_of_jobs();
+
+        available_jobs_.clear();
+        for (JobId job_id = 0; job_id < n; ++job_id)
+            if (parent->available_jobs[job_id])
+                available_jobs_.push_back(job_id);
+        JobPos number_of_available_jobs = available_jobs_.size();
+        JobPos number_of_blocks = (number_of_available_jobs + number_of_lanes - 1) / number_of_lanes;
+        bool two_machine_bounds = !machine_pairs_.empty();
+        if (two_machine_bounds)
+            compute_johnson_schedules(parent);
+        if (forward)
+            forward_bounds_.resize(number_of_blocks * number_of_lanes);
+        if (backward)
+            backward_bounds_.resize(number_of_blocks * number_of_lanes);
+
+        Time t_forward[number_of_lanes];
+        Time t_backward[number_of_lanes];
+        for (JobPos block_id = 0; block_id < number_of_blocks; ++block_id) {
+            JobPos block_start = block_id * number_of_lanes;
+            JobPos block_size = number_of_available_jobs - block_start;
+            if (block_size > number_of_lanes)
+                block_size = number_of_lanes;
+            gather_block(block_start, block_size);
+
+            // Forward.
+            if (forward) {
+                Time* b_forward = &forward_bounds_[block_start];
+                {
+                    const NodeMachine& machine = parent->machines[0];
+                    const Time* p = &block_processing_times_[0];
+                    for (JobPos lane = 0; lane < number_of_lanes; ++lane) {
+                        t_forward[lane] = machine.time_forward + p[lane];
+                        b_forward[lane] = (std::max)((Time)0,
+                                t_forward[lane]
+                                + machine.remaining_processing_time
+                                - p[lane]
+                                + machine.time_backward);
+                    }
+                    if (two_machine_bounds)
+                        store_block_times(machine, 0, t_forward, true);
+                }
+                for (MachineId machine_id = 1; machine_id < m; ++machine_id) {
+                    const NodeMachine& machine = parent->machines[machine_id];
+                    const Time* p = &block_processing_times_[machine_id * number_of_lanes];
+                    for (JobPos lane = 0; lane < number_of_lanes; ++lane) {
+                        t_forward[lane] = (std::max)(t_forward[lane], machine.time_forward) + p[lane];
+                        b_forward[lane] = (std::max)(
+                                b_forward[lane],
+                                t_forward[lane]
+                                + machine.remaining_processing_time
+                                - p[lane]
+                                + machine.time_backward);
+                    }
+                    if (two_machine_bounds)
+                        store_block_times(machine, machine_id, t_forward, true);
+                }
+                if (two_machine_bounds)
+                    update_johnson_bounds(block_start, block_size, b_forward);
+            }
+
+            // Backward.
+            if (backward) {
+                Time* b_backward = &backward_bounds_[block_start];
+                {
+                    const NodeMachine& machine = parent->machines[m - 1];
+                    const Time* p = &block_processing_times_[(m - 1) * number_of_lanes];
+                    for (JobPos lane = 0; lane < number_of_lanes; ++lane) {
+                        t_backward[lane] = machine.time_backward + p[lane];
+                        b_backward[lane] = (std::max)((Time)0,
+                                machine.time_forward
+                                + machine.remaining_processing_time
+                                - p[lane]
+                                + t_backward[lane]);
+                    }
+                    if (two_machine_bounds)
+                        store_block_times(machine, m - 1, t_backward, false);
+                }
+                for (MachineId machine_id = m - 2; machine_id >= 0; --machine_id) {
+                    const NodeMachine& machine = parent->machines[machine_id];
+                    const Time* p = &block_processing_times_[machine_id * number_of_lanes];
+                    for (JobPos lane = 0; lane < number_of_lanes; ++lane) {
+                        t_backward[lane] = (std::max)(t_backward[lane], machine.time_backward) + p[lane];
+                        b_backward[lane] = (std::max)(
+                                b_backward[lane],
+                                machine.time_forward
+                                + machine.remaining_processing_time
+                                - p[lane]
+                                + t_backward[lane]);
+                    }
+                    if (two_machine_bounds)
+                        store_block_times(machine, machine_id, t_backward, false);
+                }
+                if (two_machine_bounds)
+                    update_johnson_bounds(block_start, block_size, b_backward);
+            }
+        }
+    }
+
+    /**
+     * Store the times of the children of the current block on a machine in
+     * 'block_times_forward_' and 'block_times_backward_'.
+     *
+     * 'times' are the times of the children in the direction of the
+     * branching; in the other direction, the times are the ones of the parent.
+     */
+    inline void store_block_times(
+            const NodeMachine& machine,
+            MachineId machine_id,
+            const Time* times,
+            bool forward) const
+    {
+        Time* times_forward = &block_times_forward_[machine_id * number_of_lanes];
+        Time* times_backward = &block_times_backward_[machine_id * number_of_lanes];
+        for (JobPos lane = 0; lane < number_of_lanes; ++lane) {
+            times_forward[lane] = (forward)? times[lane]: machine.time_forward;
+            times_backward[lane] = (forward)? machine.time_backward: times[lane];
+        }
+    }
+
+    /**
+     * Compute, for each machine pair, the Johnson schedule of the available
+     * jobs of a node, so that the two-machine bound of each child can then be
+     * computed in constant time.
+     *
+     * Scheduling the jobs of the Johnson order from times (t_1, t_2) on the
+     * two machines of a pair, the completion time on the second machine is
+     * max(t_2 + B_0, max_k (t_1 + A_k + lag_k + B_k)), where A_k is the sum of
+     * the first processing times of the jobs up to position k and B_k the
+     * sum of the second processing times of the jobs from position k. For a
+     * child, the job at position q is removed: the terms before q lose its
+     * second processing time and the terms after q its first processing time.
+     * Therefore, only the prefix and suffix maxima of the terms
+     * A_k + lag_k + B_k are stored.
+     *
+     * This is computed once per expanded node, in O(number_of_machine_pairs
+     * * n), and shared by all its children.
+     */
+    void compute_johnson_schedules(
+            const std::shared_ptr<Node>& parent) const
+    {
+        JobId n = instance_.number_of_jobs();
+        JobPos number_of_available_jobs = available_jobs_.size();
+        MachinePairId number_of_machine_pairs = machine_pairs_.size();
+        johnson_positions_.resize(number_of_machine_pairs * n);
+        johnson_prefix_maxima_.resize(number_of_machine_pairs * number_of_available_jobs);
+        johnson_suffix_maxima_.resize(number_of_machine_pairs * number_of_available_jobs);
+        johnson_total_processing_times_.resize(number_of_machine_pairs);
+        johnson_terms_.resize(number_of_available_jobs);
+        for (MachinePairId pair_id = 0; pair_id < number_of_machine_pairs; ++pair_id) {
+            const MachinePair& pair = machine_pairs_[pair_id];
+            const Time* processing_times_1 = &processing_times_[pair.machine_id_1 * n];
+            const Time* processing_times_2 = &processing_times_[pair.machine_id_2 * n];
+            const Time* lags = &lags_[pair_id * n];
+            const JobId* order = &johnson_orders_[pair_id * n];
+            JobPos* positions = &johnson_positions_[pair_id * n];
+
+            // A_k + lag_k, then B_k is added backward.
+            JobPos pos = 0;
+            Time a = 0;
+            for (JobPos johnson_pos = 0; johnson_pos < n; ++johnson_pos) {
+                JobId job_id = order[johnson_pos];
+                if (!parent->available_jobs[job_id])
+                    continue;
+                positions[job_id] = pos;
+                a += processing_times_1[job_id];
+                johnson_terms_[pos] = a + lags[job_id];
+                pos++;
+            }
+            Time b = 0;
+            for (JobPos johnson_pos = n - 1; johnson_pos >= 0; --johnson_pos) {
+                JobId job_id = order[johnson_pos];
+                if (!parent->available_jobs[job_id])
+                    continue;
+                b += processing_times_2[job_id];
+                johnson_terms_[positions[job_id]] += b;
+            }
+            johnson_total_processing_times_[pair_id] = b;
+
+            Time* prefix_maxima = &johnson_prefix_maxima_[pair_id * number_of_available_jobs];
+            Time* suffix_maxima = &johnson_suffix_maxima_[pair_id * number_of_available_jobs];
+            Time maximum = johnson_empty_maximum;
+            for (JobPos pos = 0; pos < number_of_available_jobs; ++pos) {
+                prefix_maxima[pos] = maximum;
+                maximum = (std::max)(maximum, johnson_terms_[pos]);
+            }
+            maximum = johnson_empty_maximum;
+            for (JobPos pos = number_of_available_jobs - 1; pos >= 0; --pos) {
+                suffix_maxima[pos] = maximum;
+                maximum = (std::max)(maximum, johnson_terms_[pos]);
+            }
+        }
+    }
+
+    /**
+     * Update the bounds of the children of the current block with the
+     * two-machine bounds.
+     *
+     * 'store_block_times' must have been called on each machine before.
+     *
+     * For each machine pair (k, l), the remaining jobs of a child are
+     * scheduled in the Johnson order of the pair, starting at the times of
+     * the child on machines k and l in the forward direction. The bound is
+     * the completion time on machine l plus the time of the child on machine
+     * l in the backward direction. It is obtained in constant time from the
+     * schedule computed by 'compute_johnson_schedules'.
+     */
+    void update_johnson_bounds(
+            JobPos block_start,
+            JobPos block_size,
+            Time* bounds) const
+    {
+        JobId n = instance_.number_of_jobs();
+        JobPos number_of_available_jobs = available_jobs_.size();
+        MachinePairId number_of_machine_pairs = machine_pairs_.size();
+
+        JobId lane_job_ids[number_of_lanes];
+        for (JobPos lane = 0; lane < number_of_lanes; ++lane)
+            lane_job_ids[lane] = available_jobs_[block_start + (std::min)(lane, block_size - 1)];
+
+        for (MachinePairId pair_id = 0; pair_id < number_of_machine_pairs; ++pair_id) {
+            const MachinePair& pair = machine_pairs_[pair_id];
+            const Time* processing_times_1 = &processing_times_[pair.machine_id_1 * n];
+            const Time* processing_times_2 = &processing_times_[pair.machine_id_2 * n];
+            const JobPos* positions = &johnson_positions_[pair_id * n];
+            const Time* prefix_maxima = &johnson_prefix_maxima_[pair_id * number_of_available_jobs];
+            const Time* suffix_maxima = &johnson_suffix_maxima_[pair_id * number_of_available_jobs];
+            Time total_processing_time = johnson_total_processing_times_[pair_id];
+            const Time* times_1 = &block_times_forward_[pair.machine_id_1 * number_of_lanes];
+            const Time* times_2 = &block_times_forward_[pair.machine_id_2 * number_of_lanes];
+            const Time* times_backward = &block_times_backward_[pair.machine_id_2 * number_of_lanes];
+            for (JobPos lane = 0; lane < number_of_lanes; ++lane) {
+                JobId job_id = lane_job_ids[lane];
+                JobPos pos = positions[job_id];
+                Time p_1 = processing_times_1[job_id];
+                Time p_2 = processing_times_2[job_id];
+                Time t = (std::max)(
+                        times_2[lane] + total_processing_time - p_2,
+                        times_1[lane] + (std::max)(
+                            prefix_maxima[pos] - p_2,
+                            suffix_maxima[pos] - p_1));
+                bounds[lane] = (std::max)(bounds[lane], t + times_backward[lane]);
+            }
+        }
+    }
+
+    /**
+     * Compute the structures of a node, choose its direction and compute its
+     * children in this direction.
+     */
+    void compute_children(
+            const std::shared_ptr<Node>& parent) const
+    {
+        // Compute parent's structures.
+        if (parent->machines.empty())
+            compute_structures(parent);
+
+        // Determine wether to use forward or backward.
+        if (!parameters_.bidirectional) {
+            parent->forward = true;
+            compute_bounds(parent, true, false);
+        } else if (parent->parent == nullptr) {
+            parent->forward = true;
+            compute_bounds(parent, true, false);
+        } else if (parent->parent->parent == nullptr) {
+            parent->forward = false;
+            compute_bounds(parent, false, true);
+        } else {
+            compute_bounds(parent, true, true);
+            JobId n = instance_.number_of_jobs();
+            Time cutoff = (best_node_->number_of_jobs == n)?
+                best_node_->bound:
+                std::numeric_limits<Time>::max();
+            JobPos n_forward = 0;
+            JobPos n_backward = 0;
+            Time bound_forward = 0;
+            Time bound_backward = 0;
+            for (JobPos pos = 0; pos < (JobPos)available_jobs_.size(); ++pos) {
+                if (forward_bounds_[pos] < cutoff) {
+                    n_forward++;
+                    bound_forward += forward_bounds_[pos];
+                }
+                if (backward_bounds_[pos] < cutoff) {
+                    n_backward++;
+                    bound_backward += backward_bounds_[pos];
+                }
+            }
+            if (n_forward < n_backward) {
+                parent->forward = true;
+            } else if (n_forward > n_backward) {
+                parent->forward = false;
+            } else if (bound_forward > bound_backward) {
+                parent->forward = true;
+            } else if (bound_forward < bound_backward) {
+                parent->forward = false;
+            } else {
+                parent->forward = !parent->parent->forward;
+            }
+        }
+
+        compute_idle_times(parent);
+    }
+
+    /**
+     * Create the child of a node from its data computed by
+     * 'compute_children'.
+     */
+    inline std::shared_ptr<Node> create_child(
+            const std::shared_ptr<Node>& parent,
+            JobId job_id,
+            JobPos pos) const
+    {
+        // Compute new child.
+        MachineId m = instance_.number_of_machines();
+        JobId n = instance_.number_of_jobs();
+        auto child = std::shared_ptr<Node>(new BranchingSchemeBidirectional::Node());
+        child->node_id = node_id_;
+        node_id_++;
+        child->parent = parent;
+        child->job_id = job_id;
+        child->available_jobs_hash = parent->available_jobs_hash ^ job_hashes_[job_id];
+        child->number_of_jobs = parent->number_of_jobs + 1;
+        child->bound = parent->children[pos].bound;
+        child->idle_time = parent->children[pos].idle_time;
+        child->weighted_idle_time = parent->children[pos].weighted_idle_time;
+        // Compute guide.
+        double alpha = (double)child->number_of_jobs / n;
+        switch (parameters_.guide_id) {
+        case 0: {
+            child->guide = child->bound;
+            break;
+        } case 1: {
+            child->guide = child->idle_time;
+            break;
+        } case 2: {
+            child->guide = alpha * child->bound
+                + (1.0 - alpha) * child->idle_time * child->number_of_jobs / m;
+            break;
+        } case 3: {
+            child->guide = alpha * child->bound
+                + (1.0 - alpha) * child->weighted_idle_time * child->bound;
+            break;
+        } case 4: {
+            double a1 = (best_node_->number_of_jobs == instance_.number_of_jobs())?
+                (double)(best_node_->bound) / (best_node_->bound - child->bound):
+                1 - alpha;
+            double a2 = (best_node_->number_of_jobs == instance_.number_of_jobs())?
+                (double)(best_node_->bound - child->bound) / best_node_->bound:
+                alpha;
+            child->guide = a1 * child->bound
+                + a2 * child->weighted_idle_time;
+            break;
+        } default: {
+        }
+        }
+        if (better(child, best_node_))
+            best_node_ = child;
+        return child;
+    }
+
+    /**
+     * Compute the idle times of the children of a node in its chosen
+     * direction, and store the children data in the node.
+     *
+     * 'compute_bounds' must have been called on the node before; the bounds
+     * it computed are reused. The terms of the weighted idle times which only
+     * depend on the parent are computed once for all the children, and the
+     * terms are summed in the same order as when computing a single child.
+     */
+    void compute_idle_times(
+            const std::shared_ptr<Node>& parent) const
+    {
+        MachineId m = instance_.number_of_machines();
+        JobPos number_of_available_jobs = available_jobs_.size();
+        JobPos number_of_blocks = (number_of_available_jobs + number_of_lanes - 1) / number_of_lanes;
+        const std::vector<Time>& bounds = (parent->forward)?
+            forward_bounds_:
+            backward_bounds_;
+        parent->children.resize(number_of_available_jobs);
+
+        // Ratios between the idle time and the completion time of the
+        // machines in the opposite direction.
+        idle_time_ratios_.resize(m);
+        for (MachineId machine_id = 0; machine_id < m; ++machine_id) {
+            const NodeMachine& machine = parent->machines[machine_id];
+            if (parent->forward) {
+                idle_time_ratios_[machine_id] = (machine.time_backward == 0)? 1:
+                    (double)machine.idle_time_backward / machine.time_backward;
+            } else {
+                idle_time_ratios_[machine_id] = (machine.time_forward == 0)? 1:
+                    (double)machine.idle_time_forward / machine.time_forward;
+            }
+        }
+
+        // The machine data is copied in local variables and the lanes are
+        // accumulated in local arrays so that the compiler knows they don't
+        // alias the outputs.
+        Time t_prec[number_of_lanes];
+        Time idle_times[number_of_lanes];
+        double weighted_idle_times[number_of_lanes];
+        for (JobPos block_id = 0; block_id < number_of_blocks; ++block_id) {
+            JobPos block_start = block_id * number_of_lanes;
+            JobPos block_size = number_of_available_jobs - block_start;
+            if (block_size > number_of_lanes)
+                block_size = number_of_lanes;
+            gather_block(block_start, block_size);
+
+            if (parent->forward) {
+                {
+                    const Time* p = &block_processing_times_[0];
+                    Time time = parent->machines[0].time_forward;
+                    Time idle_time = parent->idle_time;
+                    double ratio = idle_time_ratios_[0];
+                    for (JobPos lane = 0; lane < number_of_lanes; ++lane) {
+                        t_prec[lane] = time + p[lane];
+                        idle_times[lane] = idle_time;
+                        weighted_idle_times[lane] = 0;
+                        weighted_idle_times[lane] += ratio;
+                    }
+                }
+                for (MachineId machine_id = 1; machine_id < m; ++machine_id) {
+                    const Time* p = &block_processing_times_[machine_id * number_of_lanes];
+                    Time time = parent->machines[machine_id].time_forward;
+                    Time machine_idle_time = parent->machines[machine_id].idle_time_forward;
+                    double ratio = idle_time_ratios_[machine_id];
+                    for (JobPos lane = 0; lane < number_of_lanes; ++lane) {
+                        Time idle_time = (std::max)((Time)0, t_prec[lane] - time);
+                        Time t = (std::max)(t_prec[lane], time) + p[lane];
+                        idle_times[lane] += idle_time;
+                        // Branch-free version of
+                        // 't == 0? 1: (machine_idle_time + idle_time) / t'.
+                        double r = (double)(machine_idle_time + idle_time)
+                            / ((t == 0)? 1: (double)t);
+                        weighted_idle_times[lane] += (t == 0)? 1: r;
+                        weighted_idle_times[lane] += ratio;
+                        t_prec[lane] = t;
+                    }
+                }
+            } else {
+                {
+                    const Time* p = &block_processing_times_[(m - 1) * number_of_lanes];
+                    Time time = parent->machines[m - 1].time_backward;
+                    Time idle_time = parent->idle_time;
+                    double ratio = idle_time_ratios_[m - 1];
+                    for (JobPos lane = 0; lane < number_of_lanes; ++lane) {
+                        t_prec[lane] = time + p[lane];
+                        idle_times[lane] = idle_time;
+                        weighted_idle_times[lane] = 0;
+                        weighted_idle_times[lane] += ratio;
+                    }
+                }
+                for (MachineId machine_id = m - 2; machine_id >= 0; --machine_id) {
+                    const Time* p = &block_processing_times_[machine_id * number_of_lanes];
+                    Time time = parent->machines[machine_id].time_backward;
+                    Time machine_idle_time = parent->machines[machine_id].idle_time_backward;
+                    double ratio = idle_time_ratios_[machine_id];
+                    for (JobPos lane = 0; lane < number_of_lanes; ++lane) {
+                        Time idle_time = (std::max)((Time)0, t_prec[lane] - time);
+                        Time t = (std::max)(t_prec[lane], time) + p[lane];
+                        idle_times[lane] += idle_time;
+                        double r = (double)(machine_idle_time + idle_time)
+                            / ((t == 0)? 1: (double)t);
+                        weighted_idle_times[lane] += ratio;
+                        weighted_idle_times[lane] += (t == 0)? 1: r;
+                        t_prec[lane] = t;
+                    }
+                }
+            }
+
+            for (JobPos lane = 0; lane < block_size; ++lane) {
+                NodeChild& child = parent->children[block_start + lane];
+                child.bound = bounds[block_start + lane];
+                child.idle_time = idle_times[lane];
+                child.weighted_idle_time = weighted_idle_times[lane];
+            }
+        }
+    }
+
+    /** Free the data computed to generate the children of an infertile node. */
+    void free_children(
+            const std::shared_ptr<Node>& node) const
+    {
+        if (!infertile(node))
+            return;
+        std::vector<NodeChild>().swap(node->children);
+    }
+
+    using MachinePairId = int64_t;
+
+    /** Pair of machines of a two-machine bound. */
+    struct MachinePair
+    {
+        /** First machine. */
+        MachineId machine_id_1;
+
+        /** Second machine. */
+        MachineId machine_id_2;
+    };
+
     /** Instance. */
     const Instance& instance_;
 
     /** Parameters. */
     Parameters parameters_;
 
+    /** For each job, random value used to hash the sets of available jobs. */
+    std::vector<uint64_t> job_hashes_;
+
+    /** Machine pairs of the two-machine bounds. */
+    std::vector<MachinePair> machine_pairs_;
+
+    /**
+     * Lags of the machine pairs: the lag of job 'j' for pair 'p' is at index
+     * 'p * n + j'; it is the sum of its processing times on the machines
+     * between the two machines of the pair.
+     */
+    std::vector<Time> lags_;
+
+    /**
+     * Johnson orders of the machine pairs: the job at position 'pos' for
+     * pair 'p' is at index 'p * n + pos'.
+     */
+    std::vector<JobId> johnson_orders_;
+
+    /**
+     * Maximum over an empty set of Johnson terms; low enough to never be
+     * reached, high enough for the differences with it not to overflow.
+     */
+    static const Time johnson_empty_maximum = std::numeric_limits<Time>::min() / 4;
+
+    /**
+     * Positions of the available jobs of the node whose children are being
+     * computed in the Johnson order of each machine pair: the position of job
+     * 'j' for pair 'p' is at index 'p * n + j'.
+     */
+    mutable std::vector<JobPos> johnson_positions_;
+
+    /**
+     * For each machine pair and each position 'q' among the available jobs,
+     * maximum of the Johnson terms of the positions before 'q', at index
+     * 'p * number_of_available_jobs + q'.
+     */
+    mutable std::vector<Time> johnson_prefix_maxima_;
+
+    /** Same as 'johnson_prefix_maxima_' for the positions after 'q'. */
+    mutable std::vector<Time> johnson_suffix_maxima_;
+
+    /**
+     * For each machine pair, sum of the processing times of the available
+     * jobs on its second machine.
+     */
+    mutable std::vector<Time> johnson_total_processing_times_;
+
+    /** Johnson terms of a machine pair, by position among available jobs. */
+    mutable std::vector<Time> johnson_terms_;
+
+    /**
+     * Times of the children of the current block in the forward direction,
+     * at index 'i * number_of_lanes + l'.
+     */
+    mutable std::vector<Time> block_times_forward_;
+
+    /**
+     * Times of the children of the current block in the backward direction,
+     * at index 'i * number_of_lanes + l'.
+     */
+    mutable std::vector<Time> block_times_backward_;
+
+    /**
+     * Processing times, machine-major: the processing time of job 'j' on
+     * machine 'i' is at index 'i * n + j'.
+     */
+    std::vector<Time> processing_times_;
+
+    /** Available jobs of the node whose children are being computed. */
+    mutable std::vector<JobId> available_jobs_;
+
+    /** Bounds of the children in the forward direction. */
+    mutable std::vector<Time> forward_bounds_;
+
+    /** Bounds of the children in the backward direction. */
+    mutable std::vector<Time> backward_bounds_;
+
+    /**
+     * Ratios between the idle time and the completion time of each machine
+     * in the direction opposite to the chosen one.
+     */
+    mutable std::vector<double> idle_time_ratios_;
+
+    /**
+     * Processing times of the jobs of the current block, machine-major:
+     * the processing time of the job of lane 'l' on machine 'i' is at index
+     * 'i * number_of_lanes + l'.
+     */
+    mutable std::vector<Time> block_processing_times_;
+
     /** Best node. */
     mutable std::shared_ptr<Node> best_node_;
 
@@ -605,5 +1249,20 @@ private:
 
 };
 
+
+/**
+ * Generate a random instance with the generator of Taillard (1993).
+ */
+inline Instance generate_instance(
+        JobId number_of_jobs,
+        MachineId number_of_machines,
+        int64_t seed)
+{
+    return permutation_flowshop_scheduling::generate_instance<Instance, InstanceBuilder>(
+            number_of_jobs,
+            number_of_machines,
+            seed);
+}
+
 }
 }
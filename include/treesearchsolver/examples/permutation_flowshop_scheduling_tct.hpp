@@ -11,13 +11,19 @@
  *   - 1: idle time
  *   - 2: weighted idle time
  *   - 3: total completion time and weighted idle time
+ * - Dominance (optional): a node dominates another node with the same remaining jobs if
+ *   its total completion time and its times on all machines are smaller
  */
 
 #pragma once
 
+#include "treesearchsolver/examples/permutation_flowshop_scheduling_generator.hpp"
+
 #include "orproblems/scheduling//permutation_flowshop_scheduling_tct.hpp"
 
+#include <limits>
 #include <memory>
+#include <random>
 #include <sstream>
 
 namespace treesearchsolver
@@ -43,6 +49,12 @@ public:
         /** Array indicating for each job, if it still available. */
         std::vector<bool> available_jobs;
 
+        /**
+         * Hash of the set of available jobs, updated incrementally so that
+         * the hasher doesn't require the structures of the node.
+         */
+        uint64_t available_jobs_hash = 0;
+
         /** Last job added to the partial solution. */
         JobId job_id = -1;
 
@@ -77,6 +89,9 @@ public:
     struct Parameters
     {
         GuideId guide_id = 2;
+
+        /** Enable dominance. */
+        bool dominance = false;
     };
 
     BranchingScheme(
@@ -85,6 +100,19 @@ public:
         instance_(instance),
         parameters_(parameters)
     {
+        MachineId m = instance_.number_of_machines();
+        JobId n = instance_.number_of_jobs();
+        processing_times_.resize(m * n);
+        for (MachineId machine_id = 0; machine_id < m; ++machine_id)
+            for (JobId job_id = 0; job_id < n; ++job_id)
+                processing_times_[machine_id * n + job_id] = instance_.processing_time(job_id, machine_id);
+
+        // Random values of the jobs, whose xor over the available jobs is the
+        // hash of a node.
+        std::mt19937_64 generator(0);
+        job_hashes_.resize(n);
+        for (JobId job_id = 0; job_id < n; ++job_id)
+            job_hashes_[job_id] = generator();
     }
 
     inline const std::shared_ptr<Node> root() const
@@ -95,10 +123,12 @@ public:
         r->node_id = node_id_;
         node_id_++;
         r->available_jobs.resize(n, true);
+        for (JobId job_id = 0; job_id < n; ++job_id)
+            r->available_jobs_hash ^= job_hashes_[job_id];
         r->times.resize(m, 0);
         r->bound = 0;
         for (JobId job_id = 0; job_id < n; ++job_id)
-            r->bound += instance_.processing_time(job_id, m - 1);
+            r->bound += processing_times_[(m - 1) * n + job_id];
         return r;
     }
 
@@ -106,23 +136,32 @@ public:
             const std::shared_ptr<Node>& node) const
     {
         MachineId m = instance_.number_of_machines();
+        JobId n = instance_.number_of_jobs();
         auto parent = node->parent;
         node->available_jobs = parent->available_jobs;
         node->available_jobs[node->job_id] = false;
         node->times = parent->times;
         node->times[0] = parent->times[0]
-            + instance_.processing_time(node->job_id, 0);
+            + processing_times_[node->job_id];
         for (MachineId machine_id = 1; machine_id < m; ++machine_id) {
             if (node->times[machine_id - 1] > parent->times[machine_id]) {
                 node->times[machine_id] = node->times[machine_id - 1]
-                    + instance_.processing_time(node->job_id, machine_id);
+                    + processing_times_[machine_id * n + node->job_id];
             } else {
                 node->times[machine_id] = parent->times[machine_id]
-                    + instance_.processing_time(node->job_id, machine_id);
+                    + processing_times_[machine_id * n + node->job_id];
             }
         }
     }
 
+    /** Compute the structures of a node if they have not been computed. */
+    inline void compute_structures_if_needed(
+            const std::shared_ptr<Node>& node) const
+    {
+        if (node->times.empty())
+            compute_structures(node);
+    }
+
     inline std::shared_ptr<Node> next_child(
             const std::shared_ptr<Node>& parent) const
     {
@@ -153,57 +192,94 @@ public:
         // Compute new child.
         MachineId m = instance_.number_of_machines();
         JobId n = instance_.number_of_jobs();
-        auto child = std::shared_ptr<Node>(new BranchingScheme::Node());
-        child->node_id = node_id_;
-        node_id_++;
-        child->parent = parent;
-        child->job_id = job_id_next;
-        child->number_of_jobs = parent->number_of_jobs + 1;
-        child->idle_time = parent->idle_time;
-        child->weighted_idle_time = parent->weighted_idle_time;
+        Time idle_time = parent->idle_time;
+        double weighted_idle_time = parent->weighted_idle_time;
         Time t_prec = parent->times[0]
-            + instance_.processing_time(job_id_next, 0);
+            + processing_times_[job_id_next];
         Time t = 0;
         for (MachineId machine_id = 1; machine_id < m; ++machine_id) {
             if (t_prec > parent->times[machine_id]) {
-                Time idle_time = t_prec - parent->times[machine_id];
-                t = t_prec + instance_.processing_time(job_id_next, machine_id);
-                child->idle_time += idle_time;
-                child->weighted_idle_time += ((double)parent->number_of_jobs / n + 1) * (m - machine_id) * idle_time;
+                Time machine_idle_time = t_prec - parent->times[machine_id];
+                t = t_prec + processing_times_[machine_id * n + job_id_next];
+                idle_time += machine_idle_time;
+                weighted_idle_time += ((double)parent->number_of_jobs / n + 1) * (m - machine_id) * machine_idle_time;
             } else {
                 t = parent->times[machine_id]
-                    + instance_.processing_time(job_id_next, machine_id);
+                    + processing_times_[machine_id * n + job_id_next];
             }
             t_prec = t;
         }
-        child->total_completion_time = parent->total_completion_time + t;
-        // Compute bound.
-        child->bound = parent->bound
-            + (n - parent->number_of_jobs) * (t - parent->times[m - 1])
-            - instance_.processing_time(job_id_next, m - 1);
-        // Compute guide.
-        double alpha = (double)child->number_of_jobs / instance_.number_of_jobs();
-        switch (parameters_.guide_id) {
-        case 0: {
-            child->guide = child->bound;
-            break;
-        } case 1: {
-            child->guide = child->idle_time;
-            break;
-        } case 2: {
-            child->guide = alpha * child->total_completion_time
-                + (1.0 - alpha) * child->idle_time * child->number_of_jobs / m;
-            break;
-        } case 3: {
-            //child->guide = alpha * child->total_completion_time
-            //    + (1.0 - alpha) * (child->weighted_idle_time + m * child->idle_time) / 2;
-            child->guide = alpha * child->total_completion_time
-                + (1.0 - alpha) * (child->weighted_idle_time / m + child->idle_time) / 2 * child->number_of_jobs / m;
-            break;
-        } default: {
+        return create_child(
+                parent,
+                job_id_next,
+                t,
+                idle_time,
+                weighted_idle_time);
+    }
+
+    /**
+     * Generate all the remaining children of a node in one pass.
+     *
+     * The completion times of all the children are computed machine by
+     * machine, reading the processing times of each machine contiguously.
+     * The children are the same as the ones generated by the remaining calls
+     * to 'next_child'.
+     */
+    inline std::vector<std::shared_ptr<Node>> children(
+            const std::shared_ptr<Node>& parent) const
+    {
+        // Compute parent's structures.
+        if (parent->times.empty())
+            compute_structures(parent);
+
+        MachineId m = instance_.number_of_machines();
+        JobId n = instance_.number_of_jobs();
+        available_jobs_.clear();
+        for (JobId job_id = parent->next_child_pos; job_id < n; ++job_id)
+            if (parent->available_jobs[job_id])
+                available_jobs_.push_back(job_id);
+        JobPos number_of_available_jobs = available_jobs_.size();
+        times_.resize(number_of_available_jobs);
+        idle_times_.resize(number_of_available_jobs);
+        weighted_idle_times_.resize(number_of_available_jobs);
+
+        {
+            const Time* processing_times = &processing_times_[0];
+            for (JobPos pos = 0; pos < number_of_available_jobs; ++pos) {
+                times_[pos] = parent->times[0] + processing_times[available_jobs_[pos]];
+                idle_times_[pos] = parent->idle_time;
+                weighted_idle_times_[pos] = parent->weighted_idle_time;
+            }
         }
+        for (MachineId machine_id = 1; machine_id < m; ++machine_id) {
+            const Time* processing_times = &processing_times_[machine_id * n];
+            Time time = parent->times[machine_id];
+            double weight = ((double)parent->number_of_jobs / n + 1) * (m - machine_id);
+            for (JobPos pos = 0; pos < number_of_available_jobs; ++pos) {
+                Time t_prec = times_[pos];
+                if (t_prec > time) {
+                    Time machine_idle_time = t_prec - time;
+                    idle_times_[pos] += machine_idle_time;
+                    weighted_idle_times_[pos] += weight * machine_idle_time;
+                    times_[pos] = t_prec + processing_times[available_jobs_[pos]];
+                } else {
+                    times_[pos] = time + processing_times[available_jobs_[pos]];
+                }
+            }
         }
-        return child;
+
+        std::vector<std::shared_ptr<Node>> c;
+        c.reserve(number_of_available_jobs);
+        for (JobPos pos = 0; pos < number_of_available_jobs; ++pos) {
+            c.push_back(create_child(
+                        parent,
+                        available_jobs_[pos],
+                        times_[pos],
+                        idle_times_[pos],
+                        weighted_idle_times_[pos]));
+        }
+        parent->next_child_pos = n;
+        return c;
     }
 
     inline bool infertile(
@@ -272,7 +348,9 @@ public:
             const std::shared_ptr<Node>& node) const
     {
         (void)node;
-        return false;
+        // The structures of the nodes are only computed when they are
+        // compared, that is, when another node has the same available jobs.
+        return parameters_.dominance;
     }
 
     const Instance& instance() const { return instance_; }
@@ -280,7 +358,6 @@ public:
     struct NodeHasher
     {
         const BranchingScheme& branching_scheme_;
-        std::hash<std::vector<bool>> hasher;
 
         NodeHasher(const BranchingScheme& branching_scheme):
             branching_scheme_(branching_scheme) { }
@@ -289,6 +366,12 @@ public:
                 const std::shared_ptr<Node>& node_1,
                 const std::shared_ptr<Node>& node_2) const
         {
+            if (node_1 == node_2)
+                return true;
+            if (node_1->available_jobs_hash != node_2->available_jobs_hash)
+                return false;
+            branching_scheme_.compute_structures_if_needed(node_1);
+            branching_scheme_.compute_structures_if_needed(node_2);
             if (node_1->available_jobs != node_2->available_jobs)
                 return false;
             return true;
@@ -297,8 +380,7 @@ public:
         inline std::size_t operator()(
                 const std::shared_ptr<Node>& node) const
         {
-            size_t hash = hasher(node->available_jobs);
-            return hash;
+            return node->available_jobs_hash;
         }
     };
 
@@ -308,21 +390,24 @@ public:
             const std::shared_ptr<Node>& node_1,
             const std::shared_ptr<Node>& node_2) const
     {
-        if (node_1->total_completion_time <= node_2->total_completion_time) {
-            bool dominates = true;
-            for (MachineId machine_id = 0;
-                    machine_id < instance_.number_of_machines();
-                    ++machine_id) {
-                if (node_1->times[machine_id] > node_2->times[machine_id]) {
-                    dominates = false;
-                    break;
-                }
-            }
-            if (dominates)
-                return true;
-        }
+        compute_structures_if_needed(node_1);
+        compute_structures_if_needed(node_2);
+        if (node_1->total_completion_time > node_2->total_completion_time)
+            return false;
+        // Branch-free so that it can be vectorized.
+        MachineId m = instance_.number_of_machines();
+        const Time* times_1 = node_1->times.data();
+        const Time* times_2 = node_2->times.data();
+        bool dominates = true;
+        for (MachineId machine_id = 0; machine_id < m; ++machine_id)
+            dominates &= (times_1[machine_id] <= times_2[machine_id]);
+        return dominates;
+    }
 
-        return false;
+    inline double dominance_key(
+            const std::shared_ptr<Node>& node) const
+    {
+        return node->total_completion_time;
     }
 
     /*
@@ -345,6 +430,13 @@ public:
         return ss.str();
     }
 
+    double value(const std::shared_ptr<Node>& node) const
+    {
+        if (node->number_of_jobs != instance_.number_of_jobs())
+            return std::numeric_limits<double>::quiet_NaN();
+        return node->total_completion_time;
+    }
+
     void solution_format(
             const std::shared_ptr<Node>& node,
             std::ostream& os,
@@ -372,7 +464,13 @@ public:
             throw std::runtime_error(
                     "Unable to open file \"" + certificate_path + "\".");
         }
+        solution_write(node, file);
+    }
 
+    inline void solution_write(
+            const std::shared_ptr<Node>& node,
+            std::ostream& os) const
+    {
         std::vector<JobId> jobs;
         for (auto node_tmp = node;
                 node_tmp->parent != nullptr;
@@ -381,21 +479,109 @@ public:
         }
         std::reverse(jobs.begin(), jobs.end());
         for (JobId job_id: jobs)
-            file << job_id << " ";
+            os << job_id << " ";
     }
 
 
 private:
 
+    /**
+     * Create the child of a node obtained by adding a job, given its
+     * completion time on the last machine and its idle times.
+     */
+    inline std::shared_ptr<Node> create_child(
+            const std::shared_ptr<Node>& parent,
+            JobId job_id,
+            Time t,
+            Time idle_time,
+            double weighted_idle_time) const
+    {
+        MachineId m = instance_.number_of_machines();
+        JobId n = instance_.number_of_jobs();
+        auto child = std::shared_ptr<Node>(new BranchingScheme::Node());
+        child->node_id = node_id_;
+        node_id_++;
+        child->parent = parent;
+        child->job_id = job_id;
+        child->available_jobs_hash = parent->available_jobs_hash ^ job_hashes_[job_id];
+        child->number_of_jobs = parent->number_of_jobs + 1;
+        child->idle_time = idle_time;
+        child->weighted_idle_time = weighted_idle_time;
+        child->total_completion_time = parent->total_completion_time + t;
+        // Compute bound.
+        child->bound = parent->bound
+            + (n - parent->number_of_jobs) * (t - parent->times[m - 1])
+            - processing_times_[(m - 1) * n + job_id];
+        // Compute guide.
+        double alpha = (double)child->number_of_jobs / instance_.number_of_jobs();
+        switch (parameters_.guide_id) {
+        case 0: {
+            child->guide = child->bound;
+            break;
+        } case 1: {
+            child->guide = child->idle_time;
+            break;
+        } case 2: {
+            child->guide = alpha * child->total_completion_time
+                + (1.0 - alpha) * child->idle_time * child->number_of_jobs / m;
+            break;
+        } case 3: {
+            //child->guide = alpha * child->total_completion_time
+            //    + (1.0 - alpha) * (child->weighted_idle_time + m * child->idle_time) / 2;
+            child->guide = alpha * child->total_completion_time
+                + (1.0 - alpha) * (child->weighted_idle_time / m + child->idle_time) / 2 * child->number_of_jobs / m;
+            break;
+        } default: {
+        }
+        }
+        return child;
+    }
+
     /** Instance. */
     const Instance& instance_;
 
     /** Parameters. */
     Parameters parameters_;
 
+    /** For each job, random value used to hash the sets of available jobs. */
+    std::vector<uint64_t> job_hashes_;
+
+    /**
+     * Processing times, machine-major: the processing time of job 'j' on
+     * machine 'i' is at index 'i * n + j'.
+     */
+    std::vector<Time> processing_times_;
+
+    /** Available jobs of the node whose children are being generated. */
+    mutable std::vector<JobId> available_jobs_;
+
+    /** Completion times of the children being generated. */
+    mutable std::vector<Time> times_;
+
+    /** Idle times of the children being generated. */
+    mutable std::vector<Time> idle_times_;
+
+    /** Weighted idle times of the children being generated. */
+    mutable std::vector<double> weighted_idle_times_;
+
     mutable NodeId node_id_ = 0;
 
 };
 
+
+/**
+ * Generate a random instance with the generator of Taillard (1993).
+ */
+inline Instance generate_instance(
+        JobId number_of_jobs,
+        MachineId number_of_machines,
+        int64_t seed)
+{
+    return permutation_flowshop_scheduling::generate_instance<Instance, InstanceBuilder>(
+            number_of_jobs,
+            number_of_machines,
+            seed);
+}
+
 }
 }
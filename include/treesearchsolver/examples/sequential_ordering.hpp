@@ -7,18 +7,33 @@
  * Tree search:
  * - forward branching
  * - guide: current length + distance to the closest next child
+ * - bounds:
+ *   - 0: current length + sum, for the last visited location and each
+ *     unvisited location, of the distance to its closest neighbor
+ *   - 1: current length + maximum of the sum of the minimum outgoing arcs
+ *     and of the sum of the minimum incoming arcs, only considering the arcs
+ *     which can still be used
+ * - the children of a node are its candidate successors: the locations with a
+ *   finite distance from its last location, sorted by distance, optionally
+ *   truncated to the nearest ones
  *
  */
 
 #pragma once
 
 #include "optimizationtools/utils/utils.hpp"
-#include "optimizationtools/containers/sorted_on_demand_array.hpp"
 
 #include "orproblems/scheduling/sequential_ordering.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
 #include <memory>
+#include <random>
 #include <sstream>
+#include <stdexcept>
 
 namespace treesearchsolver
 {
@@ -28,6 +43,8 @@ namespace sequential_ordering
 using namespace orproblems::sequential_ordering;
 
 using NodeId = int64_t;
+using BoundId = int64_t;
+using PredecessorCount = uint16_t;
 
 class BranchingScheme
 {
@@ -42,6 +59,16 @@ public:
         /** Array indicating for each vertex, if it has been visited. */
         std::vector<bool> visited;
 
+        /**
+         * Array containing for each vertex, the number of its predecessors
+         * which haven't been visited, the last visited vertex being counted
+         * as visited.
+         *
+         * It is updated from the parent by only visiting the successors of
+         * the last visited vertex.
+         */
+        std::vector<PredecessorCount> number_of_unvisited_predecessors;
+
         /** Last visited vertex. */
         LocationId last_location_id = 0;
 
@@ -56,48 +83,177 @@ public:
          * neighbor.
          *
          * This is used to compute the outgoing bound efficiently.
+         *
+         * With bound 1, only the neighbors which are still unvisited are
+         * considered.
          */
         Distance bound_outgoing = 0;
 
+        /**
+         * With bound 1, sum of, for each unvisited vertex, the distance from
+         * its closest unvisited neighbor or from the last visited vertex.
+         */
+        Distance bound_incoming = 0;
+
         /** Bound. */
         Distance bound = 0;
 
         /** Guide. */
         Distance guide = 0;
 
-        /** Next child to generate. */
+        /**
+         * Position of the next child to generate among the candidate
+         * successors of the last visited vertex.
+         */
         LocationPos next_child_pos = 0;
 
         /** Unique id of the node. */
         NodeId node_id = -1;
     };
 
+    struct Parameters
+    {
+        /**
+         * Maximum number of candidate successors of each location.
+         *
+         * Only the nearest successors are kept. If negative, all the
+         * successors with a finite distance are kept. Truncating makes the
+         * search incomplete: a node whose candidates are all visited or not
+         * ready has no children.
+         */
+        LocationPos maximum_number_of_candidates = -1;
+
+        /** Bound. */
+        BoundId bound_id = 0;
+    };
+
+    /**
+     * Constructor.
+     *
+     * If 'sorted_neighbors' is not empty, it contains, for each location, all
+     * locations sorted by distance from it (see 'compute_sorted_neighbors');
+     * otherwise, they are sorted here.
+     */
     BranchingScheme(
-            const Instance& instance):
+            const Instance& instance,
+            const Parameters& parameters,
+            const std::vector<LocationId>& sorted_neighbors = {}):
         instance_(instance),
-        sorted_locations_(instance.number_of_locations()),
-        generator_(0)
+        parameters_(parameters)
     {
-        // Initialize sorted_locations_.
-        for (LocationId location_id = 0;
-                location_id < instance_.number_of_locations();
-                ++location_id) {
-            sorted_locations_[location_id].reset(instance.number_of_locations());
-            for (LocationId location_id_2 = 0;
-                    location_id_2 < instance_.number_of_locations();
-                    ++location_id_2) {
-                sorted_locations_[location_id].set_cost(
-                        location_id_2,
-                        instance_.distance(location_id, location_id_2));
+        LocationId n = instance_.number_of_locations();
+        LocationPos k = parameters_.maximum_number_of_candidates;
+
+        // Candidate successors.
+        std::vector<LocationId> neighbors;
+        candidate_offsets_.push_back(0);
+        for (LocationId location_id = 0; location_id < n; ++location_id) {
+            neighbors.clear();
+            if (!sorted_neighbors.empty()) {
+                for (LocationPos pos = 0; pos < n; ++pos) {
+                    LocationId location_id_2 = sorted_neighbors[location_id * n + pos];
+                    if (location_id_2 != location_id
+                            && instance_.distance(location_id, location_id_2)
+                            != std::numeric_limits<Distance>::max()) {
+                        neighbors.push_back(location_id_2);
+                    }
+                    if (k >= 0 && (LocationPos)neighbors.size() == k)
+                        break;
+                }
+            } else {
+                for (LocationId location_id_2 = 0; location_id_2 < n; ++location_id_2) {
+                    if (location_id_2 != location_id
+                            && instance_.distance(location_id, location_id_2)
+                            != std::numeric_limits<Distance>::max()) {
+                        neighbors.push_back(location_id_2);
+                    }
+                }
+                // Same order as 'compute_sorted_neighbors': ties are broken
+                // by location id.
+                auto compare = [this, location_id](
+                        LocationId location_id_1,
+                        LocationId location_id_2) -> bool
+                {
+                    Distance d1 = instance_.distance(location_id, location_id_1);
+                    Distance d2 = instance_.distance(location_id, location_id_2);
+                    if (d1 != d2)
+                        return d1 < d2;
+                    return location_id_1 < location_id_2;
+                };
+                if (k >= 0 && k < (LocationPos)neighbors.size()) {
+                    std::partial_sort(
+                            neighbors.begin(),
+                            neighbors.begin() + k,
+                            neighbors.end(),
+                            compare);
+                    neighbors.resize(k);
+                } else {
+                    std::sort(neighbors.begin(), neighbors.end(), compare);
+                }
             }
+            candidates_.insert(candidates_.end(), neighbors.begin(), neighbors.end());
+            candidate_offsets_.push_back(candidates_.size());
         }
-    }
 
-    inline LocationId neighbor(
-            LocationId location_id,
-            LocationPos pos) const
-    {
-        return sorted_locations_[location_id].get(pos, generator_);
+        // Successors in the precedence graph.
+        std::vector<LocationPos> number_of_successors(n, 0);
+        for (LocationId location_id = 0; location_id < n; ++location_id) {
+            if (instance_.predecessors(location_id).size()
+                    > std::numeric_limits<PredecessorCount>::max()) {
+                throw std::invalid_argument(
+                        "Too many predecessors for location "
+                        + std::to_string(location_id) + ".");
+            }
+            for (LocationId location_id_pred: instance_.predecessors(location_id))
+                number_of_successors[location_id_pred]++;
+        }
+        successor_offsets_.resize(n + 1, 0);
+        for (LocationId location_id = 0; location_id < n; ++location_id) {
+            successor_offsets_[location_id + 1] = successor_offsets_[location_id]
+                + number_of_successors[location_id];
+        }
+        successors_.resize(successor_offsets_[n]);
+        for (LocationId location_id = 0; location_id < n; ++location_id) {
+            for (LocationId location_id_pred: instance_.predecessors(location_id)) {
+                successors_[successor_offsets_[location_id_pred + 1]
+                    - number_of_successors[location_id_pred]] = location_id;
+                number_of_successors[location_id_pred]--;
+            }
+        }
+
+        // Incoming candidates, for bound 1.
+        if (parameters_.bound_id == 1) {
+            std::vector<std::vector<LocationId>> incoming_candidates(n);
+            for (LocationId location_id = 0; location_id < n; ++location_id) {
+                for (LocationPos pos = candidate_offsets_[location_id];
+                        pos < candidate_offsets_[location_id + 1];
+                        ++pos) {
+                    incoming_candidates[candidates_[pos]].push_back(location_id);
+                }
+            }
+            incoming_candidate_offsets_.push_back(0);
+            for (LocationId location_id = 0; location_id < n; ++location_id) {
+                std::vector<LocationId>& neighbors = incoming_candidates[location_id];
+                std::sort(
+                        neighbors.begin(),
+                        neighbors.end(),
+                        [this, location_id](
+                            LocationId location_id_1,
+                            LocationId location_id_2) -> bool
+                        {
+                            Distance d1 = instance_.distance(location_id_1, location_id);
+                            Distance d2 = instance_.distance(location_id_2, location_id);
+                            if (d1 != d2)
+                                return d1 < d2;
+                            return location_id_1 < location_id_2;
+                        });
+                incoming_candidates_.insert(
+                        incoming_candidates_.end(),
+                        neighbors.begin(),
+                        neighbors.end());
+                incoming_candidate_offsets_.push_back(incoming_candidates_.size());
+            }
+        }
     }
 
     inline const std::shared_ptr<Node> root() const
@@ -106,20 +262,35 @@ public:
         r->node_id = node_id_;
         node_id_++;
         r->visited.resize(instance_.number_of_locations(), false);
+        r->number_of_unvisited_predecessors.resize(
+                instance_.number_of_locations(),
+                0);
+        for (LocationId location_id = 0;
+                location_id < instance_.number_of_locations();
+                ++location_id) {
+            for (LocationId location_id_pred: instance_.predecessors(location_id))
+                if (location_id_pred != r->last_location_id)
+                    r->number_of_unvisited_predecessors[location_id]++;
+        }
 
         // Bound.
         r->bound_outgoing = 0;
+        r->bound_incoming = 0;
         for (LocationId location_id = 0;
                 location_id < instance_.number_of_locations();
                 ++location_id) {
-            Distance d = instance_.distance(location_id, neighbor(location_id, 0));
-            if (d != std::numeric_limits<Distance>::max()) {
-                r->bound_outgoing += instance_.distance(
-                        location_id,
-                        neighbor(location_id, 0));
+            r->bound_outgoing += outgoing_distance(
+                    r->visited,
+                    r->last_location_id,
+                    location_id);
+            if (parameters_.bound_id == 1
+                    && location_id != r->last_location_id) {
+                r->bound_incoming += incoming_distance(
+                        r->visited,
+                        location_id);
             }
         }
-        r->bound = r->bound_outgoing;
+        r->bound = (std::max)(r->bound_outgoing, r->bound_incoming);
 
         r->guide = r->bound;
         return r;
@@ -131,35 +302,42 @@ public:
         assert(!infertile(parent));
         assert(!leaf(parent));
 
+        const LocationId* candidates = candidates_.data() + candidate_offsets_[parent->last_location_id];
+        LocationPos number_of_candidates
+            = candidate_offsets_[parent->last_location_id + 1]
+            - candidate_offsets_[parent->last_location_id];
+
         // Get the next vertex to visit.
-        LocationId location_id_next = neighbor(parent->last_location_id, parent->next_child_pos);
+        LocationPos pos = next_candidate_pos(parent, parent->next_child_pos);
+        if (pos == number_of_candidates) {
+            parent->next_child_pos = pos;
+            parent->guide = -1;
+            return nullptr;
+        }
+
+        LocationId location_id_next = candidates[pos];
         Distance d = instance_.distance(parent->last_location_id, location_id_next);
 
         // Update parent
-        parent->next_child_pos++;
-        Distance d_next = instance_.distance(
-                parent->last_location_id,
-                neighbor(parent->last_location_id, parent->next_child_pos));
-        if (d_next == std::numeric_limits<Distance>::max()) {
+        parent->next_child_pos = next_candidate_pos(parent, pos + 1);
+        if (parent->next_child_pos == number_of_candidates) {
             parent->guide = -1;
         } else {
-            parent->bound = parent->bound - d + d_next;
+            // The remaining children leave the last visited vertex through
+            // an arc at least as long as the one to the next candidate.
+            Distance d_next = instance_.distance(
+                    parent->last_location_id,
+                    candidates[parent->next_child_pos]);
+            Distance d_last = outgoing_distance(
+                    parent->visited,
+                    parent->last_location_id,
+                    parent->last_location_id);
+            parent->bound = (std::max)(
+                    parent->bound,
+                    parent->length + parent->bound_outgoing - d_last + d_next);
             parent->guide = parent->bound;
         }
 
-        // Check if the vertex has already been visited.
-        if (parent->visited[location_id_next]
-                || d == std::numeric_limits<Distance>::max())
-            return nullptr;
-
-        // Check if the predecessors of the location have already been visited.
-        for (LocationId location_id_pred: instance_.predecessors(location_id_next)) {
-            if (location_id_pred != parent->last_location_id
-                    && !parent->visited[location_id_pred]) {
-                return nullptr;
-            }
-        }
-
         // Compute new child.
         auto child = std::shared_ptr<Node>(new BranchingScheme::Node());
         child->node_id = node_id_;
@@ -168,13 +346,24 @@ public:
         child->visited = parent->visited;
         child->visited[parent->last_location_id] = true;
         child->last_location_id = location_id_next;
+        child->number_of_unvisited_predecessors = parent->number_of_unvisited_predecessors;
+        for (LocationPos successor_pos = successor_offsets_[location_id_next];
+                successor_pos < successor_offsets_[location_id_next + 1];
+                ++successor_pos) {
+            child->number_of_unvisited_predecessors[successors_[successor_pos]]--;
+        }
         child->number_of_locations = parent->number_of_locations + 1;
         child->length = parent->length + d;
-        child->bound_outgoing = child->parent->bound_outgoing
-            - instance_.distance(
-                    parent->last_location_id,
-                    neighbor(parent->last_location_id, 0));
-        child->bound = child->length + child->bound_outgoing;
+        if (parameters_.bound_id == 0) {
+            child->bound_outgoing = child->parent->bound_outgoing
+                - nearest_distance(parent->last_location_id);
+            child->bound = child->length + child->bound_outgoing;
+        } else {
+            update_bounds(parent, child);
+            child->bound = child->length + (std::max)(
+                    child->bound_outgoing,
+                    child->bound_incoming);
+        }
         child->guide = child->bound;
         return child;
     }
@@ -301,6 +490,13 @@ public:
         return ss.str();
     }
 
+    double value(const std::shared_ptr<Node>& node) const
+    {
+        if (node->number_of_locations != instance_.number_of_locations())
+            return std::numeric_limits<double>::quiet_NaN();
+        return node->length;
+    }
+
     void solution_format(
             const std::shared_ptr<Node>& node,
             std::ostream& os,
@@ -326,7 +522,13 @@ public:
             throw std::runtime_error(
                     "Unable to open file \"" + certificate_path + "\".");
         }
+        solution_write(node, file);
+    }
 
+    inline void solution_write(
+            const std::shared_ptr<Node>& node,
+            std::ostream& os) const
+    {
         std::vector<LocationId> locations;
         for (auto node_tmp = node;
                 node_tmp->parent != nullptr;
@@ -335,23 +537,513 @@ public:
         }
         std::reverse(locations.begin(), locations.end());
         for (LocationId location_id: locations)
-            file << location_id << " ";
+            os << location_id << " ";
     }
 
 private:
 
+    /** Get the distance from a location to its nearest candidate successor. */
+    inline Distance nearest_distance(LocationId location_id) const
+    {
+        return instance_.distance(
+                location_id,
+                candidates_[candidate_offsets_[location_id]]);
+    }
+
+    /**
+     * Get the distance from a location to its closest neighbor.
+     *
+     * With bound 1, the neighbor must be unvisited. 'visited' and
+     * 'last_location_id' define the visited vertices, as in 'Node'.
+     *
+     * Returns 0 if there is no such neighbor.
+     */
+    inline Distance outgoing_distance(
+            const std::vector<bool>& visited,
+            LocationId last_location_id,
+            LocationId location_id) const
+    {
+        for (LocationPos pos = candidate_offsets_[location_id];
+                pos < candidate_offsets_[location_id + 1];
+                ++pos) {
+            LocationId location_id_2 = candidates_[pos];
+            if (parameters_.bound_id == 0
+                    || (!visited[location_id_2]
+                        && location_id_2 != last_location_id)) {
+                return instance_.distance(location_id, location_id_2);
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Get the distance to a location from its closest neighbor which is
+     * either unvisited or the last visited vertex.
+     *
+     * Returns 0 if there is no such neighbor.
+     */
+    inline Distance incoming_distance(
+            const std::vector<bool>& visited,
+            LocationId location_id) const
+    {
+        for (LocationPos pos = incoming_candidate_offsets_[location_id];
+                pos < incoming_candidate_offsets_[location_id + 1];
+                ++pos) {
+            LocationId location_id_2 = incoming_candidates_[pos];
+            if (!visited[location_id_2])
+                return instance_.distance(location_id_2, location_id);
+        }
+        return 0;
+    }
+
+    /**
+     * Compute the bounds of bound 1 of a child from the ones of its parent.
+     *
+     * Only the locations whose closest neighbor was the newly visited vertex
+     * (outgoing arcs) or the previous last visited vertex (incoming arcs) are
+     * updated.
+     */
+    inline void update_bounds(
+            const std::shared_ptr<Node>& parent,
+            const std::shared_ptr<Node>& child) const
+    {
+        LocationId location_id_prev = parent->last_location_id;
+        LocationId location_id_next = child->last_location_id;
+
+        // Outgoing arcs: the previous last visited vertex doesn't leave
+        // anymore and the new one cannot be entered anymore.
+        child->bound_outgoing = parent->bound_outgoing
+            - outgoing_distance(parent->visited, location_id_prev, location_id_prev);
+        for (LocationPos pos = incoming_candidate_offsets_[location_id_next];
+                pos < incoming_candidate_offsets_[location_id_next + 1];
+                ++pos) {
+            LocationId location_id = incoming_candidates_[pos];
+            if (child->visited[location_id])
+                continue;
+            Distance d = instance_.distance(location_id, location_id_next);
+            if (outgoing_distance(parent->visited, location_id_prev, location_id) != d)
+                continue;
+            child->bound_outgoing += outgoing_distance(
+                    child->visited,
+                    location_id_next,
+                    location_id) - d;
+        }
+
+        // Incoming arcs: the new last visited vertex is entered and the
+        // previous one cannot be left anymore.
+        child->bound_incoming = parent->bound_incoming
+            - incoming_distance(parent->visited, location_id_next);
+        for (LocationPos pos = candidate_offsets_[location_id_prev];
+                pos < candidate_offsets_[location_id_prev + 1];
+                ++pos) {
+            LocationId location_id = candidates_[pos];
+            if (child->visited[location_id]
+                    || location_id == location_id_next) {
+                continue;
+            }
+            Distance d = instance_.distance(location_id_prev, location_id);
+            if (incoming_distance(parent->visited, location_id) != d)
+                continue;
+            child->bound_incoming += incoming_distance(
+                    child->visited,
+                    location_id) - d;
+        }
+    }
+
+    /**
+     * Get the position of the first candidate successor of the last visited
+     * vertex of a node, from position 'pos', which is neither visited nor
+     * waiting for a predecessor.
+     */
+    inline LocationPos next_candidate_pos(
+            const std::shared_ptr<Node>& node,
+            LocationPos pos) const
+    {
+        LocationPos end = candidate_offsets_[node->last_location_id + 1]
+            - candidate_offsets_[node->last_location_id];
+        const LocationId* candidates = candidates_.data() + candidate_offsets_[node->last_location_id];
+        while (pos < end
+                && (node->visited[candidates[pos]]
+                    || node->number_of_unvisited_predecessors[candidates[pos]] != 0)) {
+            pos++;
+        }
+        return pos;
+    }
+
     /** Instance. */
     const Instance& instance_;
 
-    /** Sorted locations. */
-    mutable std::vector<optimizationtools::SortedOnDemandArray> sorted_locations_;
+    /** Parameters. */
+    Parameters parameters_;
+
+    /**
+     * Candidate successors of each location, sorted by distance.
+     *
+     * The candidates of location 'l' are between indices
+     * 'candidate_offsets_[l]' and 'candidate_offsets_[l + 1]'.
+     */
+    std::vector<LocationId> candidates_;
+
+    /** Offsets of the candidate successors of each location. */
+    std::vector<LocationPos> candidate_offsets_;
+
+    /**
+     * Successors of each location in the precedence graph.
+     *
+     * The successors of location 'l' are between indices
+     * 'successor_offsets_[l]' and 'successor_offsets_[l + 1]'.
+     */
+    std::vector<LocationId> successors_;
 
-    /** Generator. */
-    mutable std::mt19937_64 generator_;
+    /** Offsets of the successors of each location. */
+    std::vector<LocationPos> successor_offsets_;
+
+    /**
+     * For bound 1, locations having each location as candidate successor,
+     * sorted by distance to it.
+     */
+    std::vector<LocationId> incoming_candidates_;
+
+    /** Offsets of the incoming candidates of each location. */
+    std::vector<LocationPos> incoming_candidate_offsets_;
 
     mutable NodeId node_id_ = 0;
 
 };
 
+
+
+/**
+ * Sort, for each location, all locations by distance from it.
+ *
+ * Ties are broken by location id. Location 'location_id_2' at position 'pos'
+ * for location 'location_id' is stored at index
+ * 'location_id * number_of_locations + pos'.
+ */
+inline std::vector<LocationId> compute_sorted_neighbors(
+        const Instance& instance)
+{
+    LocationId n = instance.number_of_locations();
+    std::vector<LocationId> sorted_neighbors(n * n);
+    for (LocationId location_id = 0; location_id < n; ++location_id) {
+        auto begin = sorted_neighbors.begin() + location_id * n;
+        auto end = begin + n;
+        for (LocationId location_id_2 = 0; location_id_2 < n; ++location_id_2)
+            *(begin + location_id_2) = location_id_2;
+        std::stable_sort(
+                begin,
+                end,
+                [&instance, location_id](
+                    LocationId location_id_1,
+                    LocationId location_id_2) -> bool
+                {
+                    return instance.distance(location_id, location_id_1)
+                        < instance.distance(location_id, location_id_2);
+                });
+    }
+    return sorted_neighbors;
+}
+
+/*
+ * Binary instance cache.
+ *
+ * The cache file contains the parsed instance and the sorted neighbors. It is
+ * keyed by a hash of the content and of the format of the input file.
+ *
+ * Layout, all fields being native 64-bit integers, so that sections are
+ * 8-byte aligned and the file can be memory-mapped:
+ * - magic number, byte order mark, version, hash of the input file, number of
+ *   locations n
+ * - distances: n * n
+ * - predecessors: n + 1 offsets, then the predecessors of each location
+ * - sorted neighbors: n * n
+ */
+
+/** Magic number of the cache files ("TSSSOP" followed by 2 zero bytes). */
+const int64_t instance_cache_magic_number = 0x0000504f53535354;
+
+/** Version of the cache files. */
+const int64_t instance_cache_version = 1;
+
+/** Hash (64-bit FNV-1a) of the content and of the format of a file. */
+inline uint64_t instance_file_hash(
+        const std::string& instance_path,
+        const std::string& format)
+{
+    std::ifstream file(instance_path, std::ios::binary);
+    if (!file.good()) {
+        throw std::runtime_error(
+                "Unable to open file \"" + instance_path + "\".");
+    }
+    uint64_t hash = 14695981039346656037ULL;
+    auto update = [&hash](const char* buffer, std::streamsize size)
+    {
+        for (std::streamsize pos = 0; pos < size; ++pos) {
+            hash ^= (unsigned char)buffer[pos];
+            hash *= 1099511628211ULL;
+        }
+    };
+    std::vector<char> buffer(1 << 16);
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        update(buffer.data(), file.gcount());
+    }
+    update(format.data(), format.size());
+    return hash;
+}
+
+/** Get the path of the cache file of an instance. */
+inline std::string instance_cache_path(
+        const std::string& cache_directory,
+        uint64_t hash)
+{
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return cache_directory + "/" + ss.str() + ".sopcache";
+}
+
+/**
+ * Write the cache file of an instance.
+ *
+ * Throws if the file can't be written; the temporary file is then removed.
+ */
+inline void write_instance_cache(
+        const std::string& cache_path,
+        uint64_t hash,
+        const Instance& instance,
+        const std::vector<LocationId>& sorted_neighbors)
+{
+    LocationId n = instance.number_of_locations();
+
+    // Write in a temporary file and rename it, so that concurrent runs never
+    // read a partial cache file.
+    // Sections are written one at a time, so that the file is never copied
+    // in memory.
+    std::string tmp_path = cache_path + ".tmp" + std::to_string(std::random_device()());
+    {
+        std::ofstream file(tmp_path, std::ios::binary);
+        if (!file.good()) {
+            throw std::runtime_error(
+                    "Unable to open file \"" + tmp_path + "\".");
+        }
+        auto write = [&file](const int64_t* values, int64_t number_of_values)
+        {
+            file.write(
+                    (const char*)values,
+                    number_of_values * sizeof(int64_t));
+        };
+
+        int64_t header[5] = {
+            instance_cache_magic_number,
+            0x0102030405060708,
+            instance_cache_version,
+            (int64_t)hash,
+            n};
+        write(header, 5);
+
+        std::vector<int64_t> row(n);
+        for (LocationId location_id = 0; location_id < n; ++location_id) {
+            for (LocationId location_id_2 = 0; location_id_2 < n; ++location_id_2)
+                row[location_id_2] = instance.distance(location_id, location_id_2);
+            write(row.data(), n);
+        }
+
+        std::vector<int64_t> offsets(n + 1, 0);
+        for (LocationId location_id = 0; location_id < n; ++location_id) {
+            offsets[location_id + 1] = offsets[location_id]
+                + instance.predecessors(location_id).size();
+        }
+        write(offsets.data(), n + 1);
+
+        for (LocationId location_id = 0; location_id < n; ++location_id) {
+            const auto& predecessors = instance.predecessors(location_id);
+            row.assign(predecessors.begin(), predecessors.end());
+            write(row.data(), row.size());
+        }
+
+        for (LocationId location_id = 0; location_id < n; ++location_id) {
+            row.assign(
+                    sorted_neighbors.begin() + location_id * n,
+                    sorted_neighbors.begin() + (location_id + 1) * n);
+            write(row.data(), n);
+        }
+
+        file.close();
+        if (file.fail()) {
+            std::remove(tmp_path.c_str());
+            throw std::runtime_error(
+                    "Unable to write file \"" + tmp_path + "\".");
+        }
+    }
+#ifdef _WIN32
+    // 'rename' doesn't overwrite existing files on Windows.
+    std::remove(cache_path.c_str());
+#endif
+    if (std::rename(tmp_path.c_str(), cache_path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        throw std::runtime_error(
+                "Unable to rename file \"" + tmp_path + "\" to \"" + cache_path + "\".");
+    }
+}
+
+/**
+ * Read the cache file of an instance.
+ *
+ * Returns 'false' if the file doesn't exist or is not a valid cache file for
+ * this hash; in this case, 'instance_builder' is left untouched.
+ *
+ * The sizes stored in the file are checked against the size of the file
+ * before anything is allocated, so that a truncated or corrupted file is
+ * treated as a cache miss.
+ *
+ * The instance is still rebuilt through 'instance_builder', in time quadratic
+ * in the number of locations; a hit only saves the parsing of the input file
+ * and the sorting of the neighbors.
+ */
+inline bool read_instance_cache(
+        const std::string& cache_path,
+        uint64_t hash,
+        InstanceBuilder& instance_builder,
+        std::vector<LocationId>& sorted_neighbors)
+{
+    std::ifstream file(cache_path, std::ios::binary);
+    if (!file.good())
+        return false;
+    file.seekg(0, std::ios::end);
+    std::streamoff file_size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (file_size < 0 || file_size % sizeof(int64_t) != 0)
+        return false;
+    int64_t number_of_values = file_size / sizeof(int64_t);
+    auto read = [&file](int64_t* values, int64_t number_of_values) -> bool
+    {
+        file.read((char*)values, number_of_values * sizeof(int64_t));
+        return file.gcount() == (std::streamsize)(number_of_values * sizeof(int64_t));
+    };
+
+    int64_t header[5];
+    if (number_of_values < 5
+            || !read(header, 5)
+            || header[0] != instance_cache_magic_number
+            || header[1] != 0x0102030405060708
+            || header[2] != instance_cache_version
+            || header[3] != (int64_t)hash
+            || header[4] < 0) {
+        return false;
+    }
+    // The file must at least contain the distances, the predecessor offsets
+    // and the sorted neighbors. Divide first so that 'n * n' can't overflow.
+    int64_t n = header[4];
+    if ((n > 0 && n > number_of_values / n)
+            || 2 * n * n + n + 1 > number_of_values - 5) {
+        return false;
+    }
+    std::vector<int64_t> distances(n * n);
+    std::vector<int64_t> predecessor_offsets(n + 1);
+    if (!read(distances.data(), n * n)
+            || !read(predecessor_offsets.data(), n + 1)
+            || predecessor_offsets[0] != 0) {
+        return false;
+    }
+    for (LocationId location_id = 0; location_id < n; ++location_id)
+        if (predecessor_offsets[location_id + 1] < predecessor_offsets[location_id])
+            return false;
+    if (predecessor_offsets[n] != number_of_values - (5 + 2 * n * n + n + 1))
+        return false;
+    std::vector<int64_t> predecessors(predecessor_offsets[n]);
+    std::vector<int64_t> neighbors(n * n);
+    if (!read(predecessors.data(), predecessors.size())
+            || !read(neighbors.data(), n * n)) {
+        return false;
+    }
+    for (int64_t location_id: predecessors)
+        if (location_id < 0 || location_id >= n)
+            return false;
+    for (int64_t location_id: neighbors)
+        if (location_id < 0 || location_id >= n)
+            return false;
+
+    instance_builder.add_locations(n);
+    for (LocationId location_id = 0; location_id < n; ++location_id) {
+        for (LocationId location_id_2 = 0; location_id_2 < n; ++location_id_2) {
+            instance_builder.set_distance(
+                    location_id,
+                    location_id_2,
+                    distances[location_id * n + location_id_2]);
+        }
+        for (int64_t pos = predecessor_offsets[location_id];
+                pos < predecessor_offsets[location_id + 1];
+                ++pos) {
+            instance_builder.add_predecessor(location_id, predecessors[pos]);
+        }
+    }
+    sorted_neighbors.assign(neighbors.begin(), neighbors.end());
+    return true;
+}
+
+/**
+ * Generate a random instance.
+ *
+ * Location 0 is the start and location 'number_of_locations - 1' is the end.
+ * Distances are drawn uniformly in [1, maximum_distance]. The other locations
+ * are shuffled and each pair of them, in this order, is a precedence
+ * constraint with probability 'precedence_density', which keeps the
+ * precedence graph acyclic.
+ */
+inline Instance generate_instance(
+        LocationId number_of_locations,
+        double precedence_density,
+        Distance maximum_distance = 1000,
+        uint64_t seed = 0)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<Distance> d_distance(1, maximum_distance);
+    std::bernoulli_distribution d_precedence(precedence_density);
+    LocationId location_id_start = 0;
+    LocationId location_id_end = number_of_locations - 1;
+
+    InstanceBuilder instance_builder;
+    instance_builder.add_locations(number_of_locations);
+    for (LocationId location_id_1 = 0;
+            location_id_1 < number_of_locations;
+            ++location_id_1) {
+        if (location_id_1 == location_id_end)
+            continue;
+        for (LocationId location_id_2 = 0;
+                location_id_2 < number_of_locations;
+                ++location_id_2) {
+            if (location_id_2 == location_id_1
+                    || location_id_2 == location_id_start)
+                continue;
+            instance_builder.set_distance(
+                    location_id_1,
+                    location_id_2,
+                    d_distance(generator));
+        }
+    }
+
+    // The start precedes all locations and the end succeeds all locations.
+    for (LocationId location_id = 1;
+            location_id < number_of_locations;
+            ++location_id) {
+        instance_builder.add_predecessor(location_id, location_id_start);
+        if (location_id != location_id_end)
+            instance_builder.add_predecessor(location_id_end, location_id);
+    }
+
+    std::vector<LocationId> locations;
+    for (LocationId location_id = 1;
+            location_id < number_of_locations - 1;
+            ++location_id) {
+        locations.push_back(location_id);
+    }
+    std::shuffle(locations.begin(), locations.end(), generator);
+    for (LocationPos pos_1 = 0; pos_1 < (LocationPos)locations.size(); ++pos_1)
+        for (LocationPos pos_2 = pos_1 + 1; pos_2 < (LocationPos)locations.size(); ++pos_2)
+            if (d_precedence(generator))
+                instance_builder.add_predecessor(locations[pos_2], locations[pos_1]);
+    return instance_builder.build();
+}
+
 }
 }
@@ -4,15 +4,40 @@
  * Problem description:
  * See https://github.com/fontanf/orproblems/blob/main/include/orproblems/scheduling/simple_assembly_line_balancing_1.hpp
  *
- * TODO
+ * Tree search:
+ * - 'BranchingScheme': task-oriented branching, each child assigns one ready
+ *   job, to the current station if it fits, to a new station otherwise
+ * - 'BranchingSchemeStation': station-oriented branching, each child assigns
+ *   a maximal load to a new station
+ *   - Jackson dominance (optional): a load containing a job j is discarded if
+ *     j can be replaced by a job i which dominates it, i.e. such that i and j
+ *     are not precedence-related, p_i >= p_j and the successors of j are
+ *     successors of i
+ *     "A Computational Study of Assembly Line Balancing"
+ *     (Jackson, 1956)
+ *   - Branching either on the precedence graph or on the reversed precedence
+ *     graph; in automatic mode, the direction with the fewer loads for the
+ *     first station is selected
+ *   - Bound: number of stations + maximum of the remaining processing time
+ *     divided by the cycle time and of the number of remaining jobs longer
+ *     than half the cycle time (jobs equal to half the cycle time counting
+ *     half)
  *
  */
 
 #pragma once
 
+#include "treesearchsolver/cancellation_token.hpp"
+
+#include "optimizationtools/utils/output.hpp"
+
 #include "orproblems/scheduling/simple_assembly_line_balancing_1.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
+#include <random>
 
 namespace treesearchsolver
 {
@@ -23,6 +48,7 @@ using namespace orproblems::simple_assembly_line_balancing_1;
 
 using NodeId = int64_t;
 using GuideId = int64_t;
+using DirectionId = int64_t;
 
 class BranchingScheme
 {
@@ -37,6 +63,18 @@ public:
         /** Array indicating for each job, if it has been processed. */
         std::vector<bool> jobs;
 
+        /**
+         * Jobs which have not been processed yet and whose predecessors have
+         * all been processed, sorted by index.
+         */
+        std::vector<JobId> ready_jobs;
+
+        /**
+         * Position in 'jobs_sorted_by_processing_time_' of the unprocessed job
+         * with the smallest processing time.
+         */
+        JobPos smallest_remaining_job_pos = 0;
+
         /** Last processed job. */
         JobId job_id = -1;
 
@@ -66,6 +104,23 @@ public:
             const Instance& instance):
         instance_(instance)
     {
+        // Initialize jobs_sorted_by_processing_time_.
+        jobs_sorted_by_processing_time_.resize(instance_.number_of_jobs());
+        for (JobId job_id = 0;
+                job_id < instance_.number_of_jobs();
+                ++job_id) {
+            jobs_sorted_by_processing_time_[job_id] = job_id;
+        }
+        std::stable_sort(
+                jobs_sorted_by_processing_time_.begin(),
+                jobs_sorted_by_processing_time_.end(),
+                [&instance](JobId job_id_1, JobId job_id_2) -> bool
+                {
+                    return instance.job(job_id_1).processing_time
+                        < instance.job(job_id_2).processing_time;
+                });
+
+        number_of_remaining_predecessors_.resize(instance_.number_of_jobs());
     }
 
     inline const std::shared_ptr<Node> root() const
@@ -74,6 +129,12 @@ public:
         r->node_id = node_id_;
         node_id_++;
         r->jobs.resize(instance_.number_of_jobs(), false);
+        for (JobId job_id = 0;
+                job_id < instance_.number_of_jobs();
+                ++job_id) {
+            if (instance_.job(job_id).predecessors.empty())
+                r->ready_jobs.push_back(job_id);
+        }
         r->current_station_time = instance_.cycle_time();
         return r;
     }
@@ -82,56 +143,18 @@ public:
             const std::shared_ptr<Node>& parent) const
     {
         std::vector<std::shared_ptr<Node>> c;
+        compute_number_of_remaining_predecessors(parent);
 
         // Try to add a job in the current workstation.
         if (parent->number_of_stations > 0) {
-            for (JobId job_id = 0;
-                    job_id < instance_.number_of_jobs();
-                    ++job_id) {
-
-                // Check if the job has already been processed.
-                if (parent->jobs[job_id])
-                    continue;
+            for (JobId job_id: parent->ready_jobs) {
 
                 // Check if the job fits in the current station.
                 Time p = instance_.job(job_id).processing_time;
                 if (parent->current_station_time + p > instance_.cycle_time())
                     continue;
 
-                // Check if the predecessors of the job have already been processed.
-                bool ok = true;
-                for (JobId predecessor_id: instance_.job(job_id).predecessors) {
-                    if (!parent->jobs[predecessor_id]) {
-                        ok = false;
-                        break;
-                    }
-                }
-                if (!ok)
-                    continue;
-
-                // Compute new child.
-                auto child = std::shared_ptr<Node>(new BranchingScheme::Node());
-                child->node_id = node_id_;
-                node_id_++;
-                child->parent = parent;
-                child->job_id = job_id;
-                child->number_of_jobs = parent->number_of_jobs + 1;
-                child->jobs = parent->jobs;
-                child->jobs[job_id] = true;
-                child->processing_time_sum = parent->processing_time_sum + p;
-                child->current_station_time = parent->current_station_time + p;
-                child->number_of_stations = parent->number_of_stations;
-                Time total_time = (child->number_of_stations - 1) * instance_.cycle_time()
-                    + child->current_station_time;
-                Time idle_time = total_time - child->processing_time_sum;
-                child->bound = std::ceil(
-                        (double)(idle_time + instance_.processing_time_sum())
-                        / instance_.cycle_time());
-                double mean_job_processing_time = (double)child->processing_time_sum
-                    / child->number_of_jobs;
-                child->guide = (double)idle_time / total_time
-                    / std::pow(mean_job_processing_time, 2);
-                c.push_back(child);
+                c.push_back(create_child(parent, job_id, false));
             }
         }
         if (!c.empty())
@@ -141,33 +164,14 @@ public:
 
         // First we look for a solitary job, that is a task which cannot share a
         // workstation with any other task.
-        Time smallest_remaining_processing_time = instance_.cycle_time() + 1;
+        Time smallest_remaining_processing_time = instance_.job(
+                jobs_sorted_by_processing_time_[parent->smallest_remaining_job_pos]).processing_time;
         // Longest valid remaining job. Valid in the sense that all its
         // predecessors have been scheduled.
         JobId longest_valid_remaining_job = -1;
         // Detect if there is a job with successors (for successor rule).
         bool has_job_with_successors = false;
-        for (JobId job_id = 0;
-                job_id < instance_.number_of_jobs();
-                ++job_id) {
-
-            // Check if the job has already been processed.
-            if (parent->jobs[job_id])
-                continue;
-
-            Time p = instance_.job(job_id).processing_time;
-            if (smallest_remaining_processing_time > p)
-                smallest_remaining_processing_time = p;
-
-            bool ok = true;
-            for (JobId predecessor_id: instance_.job(job_id).predecessors) {
-                if (!parent->jobs[predecessor_id]) {
-                    ok = false;
-                    break;
-                }
-            }
-            if (!ok)
-                continue;
+        for (JobId job_id: parent->ready_jobs) {
 
             if (!instance_.job(job_id).successors.empty())
                 has_job_with_successors = true;
@@ -181,44 +185,14 @@ public:
 
         // If a solitary task has been found, only generate the child node
         // corresponding to its insertion in a new station.
-        Time p = instance_.job(longest_valid_remaining_job).processing_time;
         if (instance_.job(longest_valid_remaining_job).processing_time
                 + smallest_remaining_processing_time
                 >= instance_.cycle_time()) {
-
-            // Compute new child.
-            auto child = std::shared_ptr<Node>(new BranchingScheme::Node());
-            child->node_id = node_id_;
-            node_id_++;
-            child->parent = parent;
-            child->job_id = longest_valid_remaining_job;
-            child->number_of_jobs = parent->number_of_jobs + 1;
-            child->jobs = parent->jobs;
-            child->jobs[longest_valid_remaining_job] = true;
-            child->processing_time_sum = parent->processing_time_sum + p;
-            child->current_station_time = p;
-            child->number_of_stations = parent->number_of_stations + 1;
-            Time total_time = (child->number_of_stations - 1) * instance_.cycle_time()
-                + child->current_station_time;
-            Time idle_time = total_time - child->processing_time_sum;
-            child->bound = std::ceil(
-                    (double)(idle_time + instance_.processing_time_sum())
-                    / instance_.cycle_time());
-            double mean_job_processing_time = (double)child->processing_time_sum
-                / child->number_of_jobs;
-            child->guide = (double)idle_time / total_time
-                / std::pow(mean_job_processing_time, 2);
-            c.push_back(child);
+            c.push_back(create_child(parent, longest_valid_remaining_job, true));
             return c;
         }
 
-        for (JobId job_id = 0;
-                job_id < instance_.number_of_jobs();
-                ++job_id) {
-
-            // Check if the job has already been processed.
-            if (parent->jobs[job_id])
-                continue;
+        for (JobId job_id: parent->ready_jobs) {
 
             // Apply successor rule.
             if (has_job_with_successors
@@ -226,42 +200,7 @@ public:
                 continue;
             }
 
-            // Check if the predecessors of the job have already been processed.
-            bool ok = true;
-            for (JobId predecessor_id: instance_.job(job_id).predecessors) {
-                if (!parent->jobs[predecessor_id]) {
-                    ok = false;
-                    break;
-                }
-            }
-            if (!ok)
-                continue;
-
-            Time p = instance_.job(job_id).processing_time;
-
-            // Compute new child.
-            auto child = std::shared_ptr<Node>(new BranchingScheme::Node());
-            child->node_id = node_id_;
-            node_id_++;
-            child->parent = parent;
-            child->job_id = job_id;
-            child->number_of_jobs = parent->number_of_jobs + 1;
-            child->jobs = parent->jobs;
-            child->jobs[job_id] = true;
-            child->processing_time_sum = parent->processing_time_sum + p;
-            child->current_station_time = p;
-            child->number_of_stations = parent->number_of_stations + 1;
-            Time total_time = (child->number_of_stations - 1) * instance_.cycle_time()
-                + child->current_station_time;
-            Time idle_time = total_time - child->processing_time_sum;
-            child->bound = std::ceil(
-                    (double)(idle_time + instance_.processing_time_sum())
-                    / instance_.cycle_time());
-            double mean_job_processing_time = (double)child->processing_time_sum
-                / child->number_of_jobs;
-            child->guide = (double)idle_time / total_time
-                / std::pow(mean_job_processing_time, 2);
-            c.push_back(child);
+            c.push_back(create_child(parent, job_id, true));
         }
 
         return c;
@@ -386,6 +325,13 @@ public:
         return std::to_string(node->number_of_stations);
     }
 
+    double value(const std::shared_ptr<Node>& node) const
+    {
+        if (node->number_of_jobs != instance_.number_of_jobs())
+            return std::numeric_limits<double>::quiet_NaN();
+        return node->number_of_stations;
+    }
+
     void solution_format(
             std::ostream &os,
             const std::shared_ptr<Node>& node,
@@ -438,7 +384,13 @@ public:
             throw std::runtime_error(
                     "Unable to open file \"" + certificate_path + "\".");
         }
+        solution_write(node, file);
+    }
 
+    inline void solution_write(
+            const std::shared_ptr<Node>& node,
+            std::ostream& os) const
+    {
         std::vector<std::vector<JobId>> stations(node->number_of_stations);
         for (auto node_tmp = node;
                 node_tmp->parent != nullptr;
@@ -450,21 +402,958 @@ public:
                 station_id < node->number_of_stations;
                 ++station_id) {
             std::reverse(stations[station_id].begin(), stations[station_id].end());
-            file << stations[station_id].size();
+            os << stations[station_id].size();
             for (JobId job_id: stations[station_id])
-                file << " " << job_id;
-            file << std::endl;
+                os << " " << job_id;
+            os << std::endl;
         }
     }
 
 private:
 
+    /**
+     * Compute the number of unprocessed predecessors of the successors of the
+     * ready jobs of a node.
+     *
+     * The counters are not stored in the nodes: they are only needed for the
+     * jobs which may become ready in a child.
+     */
+    inline void compute_number_of_remaining_predecessors(
+            const std::shared_ptr<Node>& parent) const
+    {
+        for (JobId job_id: parent->ready_jobs) {
+            for (JobId successor_id: instance_.job(job_id).successors) {
+                JobId number_of_remaining_predecessors = 0;
+                for (JobId predecessor_id: instance_.job(successor_id).predecessors)
+                    if (!parent->jobs[predecessor_id])
+                        number_of_remaining_predecessors++;
+                number_of_remaining_predecessors_[successor_id]
+                    = number_of_remaining_predecessors;
+            }
+        }
+    }
+
+    /**
+     * Create the child of a node obtained by processing a ready job, either
+     * in the current station or in a new station.
+     */
+    inline std::shared_ptr<Node> create_child(
+            const std::shared_ptr<Node>& parent,
+            JobId job_id,
+            bool new_station) const
+    {
+        Time p = instance_.job(job_id).processing_time;
+        auto child = std::shared_ptr<Node>(new BranchingScheme::Node());
+        child->node_id = node_id_;
+        node_id_++;
+        child->parent = parent;
+        child->job_id = job_id;
+        child->number_of_jobs = parent->number_of_jobs + 1;
+        child->jobs = parent->jobs;
+        child->jobs[job_id] = true;
+
+        // Update the ready jobs. Only the successors of the new job whose only
+        // unprocessed predecessor was the new job become ready.
+        child->ready_jobs.reserve(
+                parent->ready_jobs.size()
+                + instance_.job(job_id).successors.size());
+        for (JobId job_id_2: parent->ready_jobs)
+            if (job_id_2 != job_id)
+                child->ready_jobs.push_back(job_id_2);
+        for (JobId successor_id: instance_.job(job_id).successors) {
+            if (number_of_remaining_predecessors_[successor_id] == 1) {
+                child->ready_jobs.insert(
+                        std::upper_bound(
+                            child->ready_jobs.begin(),
+                            child->ready_jobs.end(),
+                            successor_id),
+                        successor_id);
+            }
+        }
+
+        // Update the unprocessed job with the smallest processing time.
+        child->smallest_remaining_job_pos = parent->smallest_remaining_job_pos;
+        while (child->smallest_remaining_job_pos < instance_.number_of_jobs()
+                && child->jobs[jobs_sorted_by_processing_time_[child->smallest_remaining_job_pos]]) {
+            child->smallest_remaining_job_pos++;
+        }
+
+        child->processing_time_sum = parent->processing_time_sum + p;
+        if (new_station) {
+            child->current_station_time = p;
+            child->number_of_stations = parent->number_of_stations + 1;
+        } else {
+            child->current_station_time = parent->current_station_time + p;
+            child->number_of_stations = parent->number_of_stations;
+        }
+        Time total_time = (child->number_of_stations - 1) * instance_.cycle_time()
+            + child->current_station_time;
+        Time idle_time = total_time - child->processing_time_sum;
+        child->bound = std::ceil(
+                (double)(idle_time + instance_.processing_time_sum())
+                / instance_.cycle_time());
+        double mean_job_processing_time = (double)child->processing_time_sum
+            / child->number_of_jobs;
+        child->guide = (double)idle_time / total_time
+            / std::pow(mean_job_processing_time, 2);
+        return child;
+    }
+
     /** Instance. */
     const Instance& instance_;
 
+    /** Jobs sorted by non-decreasing processing time. */
+    std::vector<JobId> jobs_sorted_by_processing_time_;
+
+    /**
+     * Number of unprocessed predecessors of the successors of the ready jobs
+     * of the node being expanded.
+     */
+    mutable std::vector<JobId> number_of_remaining_predecessors_;
+
     mutable NodeId node_id_ = 0;
 
 };
 
+
+class BranchingSchemeStation
+{
+
+public:
+
+    struct Node
+    {
+        /** Parent node. */
+        std::shared_ptr<Node> parent = nullptr;
+
+        /** Array indicating for each job, if it has been assigned. */
+        std::vector<bool> jobs;
+
+        /**
+         * Jobs which have not been assigned yet and whose predecessors have
+         * all been assigned.
+         */
+        std::vector<JobId> ready_jobs;
+
+        /** Jobs of the last station, in a precedence-feasible order. */
+        std::vector<JobId> station_jobs;
+
+        /** Number of jobs assigned. */
+        JobId number_of_jobs = 0;
+
+        /** Number of stations in the partial solution. */
+        StationId number_of_stations = 0;
+
+        /** Sum of the processing time of all assigned jobs. */
+        Time processing_time_sum = 0;
+
+        /**
+         * Number of unassigned jobs whose processing time is greater than half
+         * the cycle time.
+         */
+        JobId number_of_remaining_large_jobs = 0;
+
+        /**
+         * Number of unassigned jobs whose processing time is equal to half the
+         * cycle time.
+         */
+        JobId number_of_remaining_half_jobs = 0;
+
+        /** Bound. */
+        StationId bound = -1;
+
+        /** Guide. */
+        double guide = 0;
+
+        /** Unique id of the node. */
+        NodeId node_id = -1;
+    };
+
+    struct Parameters
+    {
+        /**
+         * Direction.
+         *
+         * - 0: forward, on the precedence graph
+         * - 1: backward, on the reversed precedence graph
+         * - 2: the direction with the fewer loads for the first station
+         */
+        DirectionId direction_id = 2;
+
+        /** Enable Jackson dominance. */
+        bool jackson_dominance = true;
+
+        /**
+         * Maximum number of loads generated when expanding a node.
+         *
+         * Loads are enumerated by adding the longest jobs first. If negative,
+         * all the maximal loads are generated. Truncating makes the search
+         * incomplete; the number of truncated expansions is reported by
+         * 'to_json'.
+         */
+        NodeId maximum_number_of_loads = -1;
+    };
+
+    BranchingSchemeStation(
+            const Instance& instance,
+            const Parameters& parameters):
+        instance_(instance),
+        parameters_(parameters)
+    {
+        JobId n = instance_.number_of_jobs();
+        in_load_.resize(n, false);
+        excluded_.resize(n, false);
+        ready_.resize(n, false);
+        number_of_remaining_predecessors_.resize(n);
+
+        if (parameters_.direction_id == 2) {
+            // Count the loads of the first station in both directions, with
+            // the same amount of work in each direction.
+            set_direction(false);
+            NodeId number_of_loads_forward = number_of_loads(root());
+            set_direction(true);
+            NodeId number_of_loads_backward = number_of_loads(root());
+            set_direction(number_of_loads_backward < number_of_loads_forward);
+            node_id_ = 0;
+        } else {
+            set_direction(parameters_.direction_id == 1);
+        }
+    }
+
+    /** Return 'true' iff the reversed precedence graph is used. */
+    inline bool reverse() const { return reverse_; }
+
+    /**
+     * Set the cancellation token of the algorithm.
+     *
+     * The enumeration of the loads stops once it is cancelled, since the
+     * number of loads of a station may be exponential in the number of jobs.
+     */
+    inline void set_cancellation_token(
+            const std::shared_ptr<CancellationToken>& cancellation_token) const
+    {
+        cancellation_token_ = cancellation_token;
+    }
+
+    inline const std::shared_ptr<Node> root() const
+    {
+        auto r = std::shared_ptr<Node>(new BranchingSchemeStation::Node());
+        r->node_id = node_id_;
+        node_id_++;
+        r->jobs.resize(instance_.number_of_jobs(), false);
+        for (JobId job_id = 0;
+                job_id < instance_.number_of_jobs();
+                ++job_id) {
+            if (predecessors_[job_id].empty())
+                r->ready_jobs.push_back(job_id);
+            Time p = instance_.job(job_id).processing_time;
+            if (2 * p > instance_.cycle_time()) {
+                r->number_of_remaining_large_jobs++;
+            } else if (2 * p == instance_.cycle_time()) {
+                r->number_of_remaining_half_jobs++;
+            }
+        }
+        compute_bound_and_guide(*r);
+        return r;
+    }
+
+    inline std::vector<std::shared_ptr<Node>> children(
+            const std::shared_ptr<Node>& parent) const
+    {
+        std::vector<std::shared_ptr<Node>> c;
+        NodeId number_of_loads = 0;
+        initialize_loads(parent);
+        add_loads(
+                parent,
+                parent->ready_jobs,
+                0,
+                parameters_.maximum_number_of_loads,
+                number_of_loads,
+                &c);
+        if (loads_truncated_)
+            number_of_truncated_expansions_++;
+        return c;
+    }
+
+    inline bool operator()(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2) const
+    {
+        if (node_1->guide != node_2->guide)
+            return node_1->guide < node_2->guide;
+        return node_1->node_id < node_2->node_id;
+    }
+
+    inline bool leaf(
+            const std::shared_ptr<Node>& node) const
+    {
+        return node->number_of_jobs == instance_.number_of_jobs();
+    }
+
+    bool bound(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2) const
+    {
+        if (node_2->number_of_jobs != instance_.number_of_jobs())
+            return false;
+        return node_1->bound >= node_2->number_of_stations;
+    }
+
+    /*
+     * Solution pool.
+     */
+
+    bool better(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2) const
+    {
+        if (node_1->number_of_jobs < instance_.number_of_jobs())
+            return false;
+        if (node_2->number_of_jobs < instance_.number_of_jobs())
+            return true;
+        return node_1->number_of_stations < node_2->number_of_stations;
+    }
+
+    std::shared_ptr<Node> goal_node(double value) const
+    {
+        auto node = std::shared_ptr<Node>(new BranchingSchemeStation::Node());
+        node->number_of_jobs = instance_.number_of_jobs();
+        node->number_of_stations = value;
+        return node;
+    }
+
+    bool equals(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2) const
+    {
+        (void)node_1;
+        (void)node_2;
+        return false;
+    }
+
+    /*
+     * Dominances.
+     */
+
+    inline bool comparable(
+            const std::shared_ptr<Node>&) const
+    {
+        return true;
+    }
+
+    struct NodeHasher
+    {
+        std::hash<std::vector<bool>> hasher;
+
+        inline bool operator()(
+                const std::shared_ptr<Node>& node_1,
+                const std::shared_ptr<Node>& node_2) const
+        {
+            return node_1->jobs == node_2->jobs;
+        }
+
+        inline std::size_t operator()(
+                const std::shared_ptr<Node>& node) const
+        {
+            size_t hash = hasher(node->jobs);
+            return hash;
+        }
+    };
+
+    inline NodeHasher node_hasher() const { return NodeHasher(); }
+
+    inline bool dominates(
+            const std::shared_ptr<Node>& node_1,
+            const std::shared_ptr<Node>& node_2) const
+    {
+        return node_1->number_of_stations <= node_2->number_of_stations;
+    }
+
+    /*
+     * Outputs
+     */
+
+    void instance_format(
+            std::ostream& os,
+            int verbosity_level) const
+    {
+        instance_.format(os, verbosity_level);
+    }
+
+    std::string display(const std::shared_ptr<Node>& node) const
+    {
+        if (node->number_of_jobs != instance_.number_of_jobs())
+            return "";
+        return std::to_string(node->number_of_stations);
+    }
+
+    double value(const std::shared_ptr<Node>& node) const
+    {
+        if (node->number_of_jobs != instance_.number_of_jobs())
+            return std::numeric_limits<double>::quiet_NaN();
+        return node->number_of_stations;
+    }
+
+    /**
+     * Return the statistics of the branching scheme.
+     *
+     * An expansion is truncated if it reached 'maximum_number_of_loads' while
+     * loads remained to be enumerated.
+     */
+    nlohmann::json to_json() const
+    {
+        return {
+            {"MaximumNumberOfLoads", parameters_.maximum_number_of_loads},
+            {"NumberOfTruncatedExpansions", number_of_truncated_expansions_}};
+    }
+
+    void solution_format(
+            std::ostream &os,
+            const std::shared_ptr<Node>& node,
+            int verbosity_level) const
+    {
+        if (verbosity_level >= 1) {
+            os
+                << "Number of stations:  " << node->number_of_stations << std::endl
+                ;
+        }
+
+        if (verbosity_level >= 2) {
+            std::vector<std::vector<JobId>> stations = solution_stations(node);
+            os << std::endl
+                << std::setw(12) << "Station"
+                << std::setw(12) << "Time"
+                << std::setw(12) << "# jobs"
+                << std::endl
+                << std::setw(12) << "-------"
+                << std::setw(12) << "----"
+                << std::setw(12) << "------"
+                << std::endl;
+            for (StationId station_id = 0;
+                    station_id < node->number_of_stations;
+                    ++station_id) {
+                Time time = 0;
+                for (JobId job_id: stations[station_id])
+                    time += instance_.job(job_id).processing_time;
+                os
+                    << std::setw(12) << station_id
+                    << std::setw(12) << time
+                    << std::setw(12) << stations[station_id].size()
+                    << std::endl;
+            }
+        }
+    }
+
+    inline void solution_write(
+            const std::shared_ptr<Node>& node,
+            const std::string& certificate_path) const
+    {
+        if (certificate_path.empty())
+            return;
+        std::ofstream file(certificate_path);
+        if (!file.good()) {
+            throw std::runtime_error(
+                    "Unable to open file \"" + certificate_path + "\".");
+        }
+        solution_write(node, file);
+    }
+
+    inline void solution_write(
+            const std::shared_ptr<Node>& node,
+            std::ostream& os) const
+    {
+        std::vector<std::vector<JobId>> stations = solution_stations(node);
+        for (StationId station_id = 0;
+                station_id < node->number_of_stations;
+                ++station_id) {
+            os << stations[station_id].size();
+            for (JobId job_id: stations[station_id])
+                os << " " << job_id;
+            os << std::endl;
+        }
+    }
+
+private:
+
+    /**
+     * Set the precedence graph used for branching, and compute the Jackson
+     * dominances on it.
+     */
+    void set_direction(bool reverse)
+    {
+        JobId n = instance_.number_of_jobs();
+        reverse_ = reverse;
+        predecessors_.resize(n);
+        successors_.resize(n);
+        for (JobId job_id = 0; job_id < n; ++job_id) {
+            predecessors_[job_id] = (!reverse_)?
+                instance_.job(job_id).predecessors:
+                instance_.job(job_id).successors;
+            successors_[job_id] = (!reverse_)?
+                instance_.job(job_id).successors:
+                instance_.job(job_id).predecessors;
+        }
+
+        dominating_jobs_.assign(n, {});
+        if (!parameters_.jackson_dominance)
+            return;
+
+        // Topological order.
+        std::vector<JobId> order;
+        std::vector<JobId> number_of_remaining_predecessors(n);
+        for (JobId job_id = 0; job_id < n; ++job_id) {
+            number_of_remaining_predecessors[job_id] = predecessors_[job_id].size();
+            if (predecessors_[job_id].empty())
+                order.push_back(job_id);
+        }
+        for (JobPos pos = 0; pos < (JobPos)order.size(); ++pos) {
+            for (JobId successor_id: successors_[order[pos]]) {
+                number_of_remaining_predecessors[successor_id]--;
+                if (number_of_remaining_predecessors[successor_id] == 0)
+                    order.push_back(successor_id);
+            }
+        }
+
+        // Transitive successors, stored as bitsets.
+        JobPos number_of_words = (n + 63) / 64;
+        std::vector<std::vector<uint64_t>> followers(
+                n,
+                std::vector<uint64_t>(number_of_words, 0));
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            JobId job_id = *it;
+            for (JobId successor_id: successors_[job_id]) {
+                followers[job_id][successor_id / 64] |= ((uint64_t)1 << (successor_id % 64));
+                for (JobPos word = 0; word < number_of_words; ++word)
+                    followers[job_id][word] |= followers[successor_id][word];
+            }
+        }
+
+        // Job i dominates job j if they are not precedence-related,
+        // p_i >= p_j and the followers of j are followers of i. Ties are
+        // broken by index.
+        for (JobId job_id_2 = 0; job_id_2 < n; ++job_id_2) {
+            Time p_2 = instance_.job(job_id_2).processing_time;
+            const std::vector<uint64_t>& followers_2 = followers[job_id_2];
+            for (JobId job_id_1 = 0; job_id_1 < n; ++job_id_1) {
+                if (job_id_1 == job_id_2)
+                    continue;
+                Time p_1 = instance_.job(job_id_1).processing_time;
+                if (p_1 < p_2)
+                    continue;
+                const std::vector<uint64_t>& followers_1 = followers[job_id_1];
+                if ((followers_1[job_id_2 / 64] >> (job_id_2 % 64)) & 1)
+                    continue;
+                if ((followers_2[job_id_1 / 64] >> (job_id_1 % 64)) & 1)
+                    continue;
+                bool included = true;
+                bool equal = true;
+                for (JobPos word = 0; word < number_of_words; ++word) {
+                    if (followers_2[word] & ~followers_1[word]) {
+                        included = false;
+                        break;
+                    }
+                    if (followers_2[word] != followers_1[word])
+                        equal = false;
+                }
+                if (!included)
+                    continue;
+                if (p_1 == p_2 && equal && job_id_1 > job_id_2)
+                    continue;
+                dominating_jobs_[job_id_2].push_back(job_id_1);
+            }
+        }
+    }
+
+    /**
+     * Count the maximal loads of the next station of a node, without creating
+     * the children.
+     *
+     * The enumeration is bounded by 'maximum_number_of_calls_direction_'
+     * calls of 'add_loads', so that it also bounds the non-maximal and the
+     * dominated loads explored on the way. It runs before the algorithm
+     * starts, and thus can't be stopped by its time limit or its
+     * cancellation token.
+     */
+    inline NodeId number_of_loads(
+            const std::shared_ptr<Node>& parent) const
+    {
+        NodeId number_of_loads = 0;
+        initialize_loads(parent);
+        number_of_remaining_calls_ = maximum_number_of_calls_direction_;
+        add_loads(
+                parent,
+                parent->ready_jobs,
+                0,
+                -1,
+                number_of_loads,
+                nullptr);
+        number_of_remaining_calls_ = -1;
+        return number_of_loads;
+    }
+
+    /**
+     * Initialize the structures used to enumerate the loads of the next
+     * station of a node.
+     *
+     * The number of unassigned predecessors of each job is derived from the
+     * assigned jobs of the node, rather than stored in every node.
+     */
+    inline void initialize_loads(
+            const std::shared_ptr<Node>& parent) const
+    {
+        JobId n = instance_.number_of_jobs();
+        loads_truncated_ = false;
+        ready_.assign(n, false);
+        for (JobId job_id: parent->ready_jobs)
+            ready_[job_id] = true;
+        for (JobId job_id = 0; job_id < n; ++job_id) {
+            JobId number_of_remaining_predecessors = 0;
+            if (!parent->jobs[job_id])
+                for (JobId predecessor_id: predecessors_[job_id])
+                    if (!parent->jobs[predecessor_id])
+                        number_of_remaining_predecessors++;
+            number_of_remaining_predecessors_[job_id] = number_of_remaining_predecessors;
+        }
+    }
+
+    /**
+     * Enumerate the maximal loads extending the current load 'load_'.
+     *
+     * Each load is enumerated once: once the branch adding a job has been
+     * explored, the job is excluded from the following branches. A load to
+     * which an excluded job can still be added is not maximal, and is a
+     * subset of a load enumerated in a previous branch.
+     *
+     * If 'children' is null, the loads are only counted.
+     */
+    void add_loads(
+            const std::shared_ptr<Node>& parent,
+            const std::vector<JobId>& available_jobs,
+            Time station_time,
+            NodeId maximum_number_of_loads,
+            NodeId& number_of_loads,
+            std::vector<std::shared_ptr<Node>>* children) const
+    {
+        if (maximum_number_of_loads >= 0
+                && number_of_loads >= maximum_number_of_loads) {
+            loads_truncated_ = true;
+            return;
+        }
+        if (number_of_remaining_calls_ == 0) {
+            loads_truncated_ = true;
+            return;
+        }
+        if (number_of_remaining_calls_ > 0)
+            number_of_remaining_calls_--;
+        if (cancellation_token_ != nullptr && cancellation_token_->cancelled())
+            return;
+
+        // Jobs which fit in the station.
+        std::vector<JobId> branching_jobs;
+        bool excluded_job_fits = false;
+        for (JobId job_id: available_jobs) {
+            if (station_time + instance_.job(job_id).processing_time > instance_.cycle_time())
+                continue;
+            if (excluded_[job_id]) {
+                excluded_job_fits = true;
+            } else {
+                branching_jobs.push_back(job_id);
+            }
+        }
+
+        if (branching_jobs.empty()) {
+            if (!excluded_job_fits
+                    && !load_.empty()
+                    && !jackson_dominated(station_time)) {
+                number_of_loads++;
+                if (children != nullptr)
+                    children->push_back(create_child(parent, available_jobs, station_time));
+            }
+            return;
+        }
+
+        // Longest jobs first.
+        std::stable_sort(
+                branching_jobs.begin(),
+                branching_jobs.end(),
+                [this](JobId job_id_1, JobId job_id_2) -> bool
+                {
+                    return instance_.job(job_id_1).processing_time
+                        > instance_.job(job_id_2).processing_time;
+                });
+
+        std::vector<JobId> available_jobs_next;
+        for (JobId job_id: branching_jobs) {
+
+            // Add the job to the load.
+            load_.push_back(job_id);
+            in_load_[job_id] = true;
+            available_jobs_next.clear();
+            for (JobId job_id_2: available_jobs)
+                if (job_id_2 != job_id)
+                    available_jobs_next.push_back(job_id_2);
+            for (JobId successor_id: successors_[job_id]) {
+                number_of_remaining_predecessors_[successor_id]--;
+                if (number_of_remaining_predecessors_[successor_id] == 0)
+                    available_jobs_next.push_back(successor_id);
+            }
+
+            add_loads(
+                    parent,
+                    available_jobs_next,
+                    station_time + instance_.job(job_id).processing_time,
+                    maximum_number_of_loads,
+                    number_of_loads,
+                    children);
+
+            // Remove the job from the load.
+            for (JobId successor_id: successors_[job_id])
+                number_of_remaining_predecessors_[successor_id]++;
+            in_load_[job_id] = false;
+            load_.pop_back();
+            excluded_[job_id] = true;
+        }
+        for (JobId job_id: branching_jobs)
+            excluded_[job_id] = false;
+    }
+
+    /**
+     * Return 'true' iff a job of the current load without successor in the
+     * load can be replaced by a job which dominates it.
+     */
+    inline bool jackson_dominated(
+            Time station_time) const
+    {
+        Time idle_time = instance_.cycle_time() - station_time;
+        for (JobId job_id: load_) {
+            if (dominating_jobs_[job_id].empty())
+                continue;
+            bool has_successor_in_load = false;
+            for (JobId successor_id: successors_[job_id]) {
+                if (in_load_[successor_id]) {
+                    has_successor_in_load = true;
+                    break;
+                }
+            }
+            if (has_successor_in_load)
+                continue;
+            Time p = instance_.job(job_id).processing_time;
+            for (JobId job_id_2: dominating_jobs_[job_id]) {
+                if (!ready_[job_id_2] || in_load_[job_id_2])
+                    continue;
+                if (instance_.job(job_id_2).processing_time - p <= idle_time)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    inline std::shared_ptr<Node> create_child(
+            const std::shared_ptr<Node>& parent,
+            const std::vector<JobId>& available_jobs,
+            Time station_time) const
+    {
+        auto child = std::shared_ptr<Node>(new BranchingSchemeStation::Node());
+        child->node_id = node_id_;
+        node_id_++;
+        child->parent = parent;
+        child->jobs = parent->jobs;
+        child->ready_jobs = available_jobs;
+        child->station_jobs = load_;
+        child->number_of_jobs = parent->number_of_jobs + load_.size();
+        child->number_of_stations = parent->number_of_stations + 1;
+        child->processing_time_sum = parent->processing_time_sum + station_time;
+        child->number_of_remaining_large_jobs = parent->number_of_remaining_large_jobs;
+        child->number_of_remaining_half_jobs = parent->number_of_remaining_half_jobs;
+        for (JobId job_id: load_) {
+            child->jobs[job_id] = true;
+            Time p = instance_.job(job_id).processing_time;
+            if (2 * p > instance_.cycle_time()) {
+                child->number_of_remaining_large_jobs--;
+            } else if (2 * p == instance_.cycle_time()) {
+                child->number_of_remaining_half_jobs--;
+            }
+        }
+        compute_bound_and_guide(*child);
+        return child;
+    }
+
+    inline void compute_bound_and_guide(Node& node) const
+    {
+        Time c = instance_.cycle_time();
+        Time remaining_processing_time = instance_.processing_time_sum()
+            - node.processing_time_sum;
+        StationId bound_1 = (remaining_processing_time + c - 1) / c;
+        StationId bound_2 = node.number_of_remaining_large_jobs
+            + (node.number_of_remaining_half_jobs + 1) / 2;
+        node.bound = node.number_of_stations + std::max(bound_1, bound_2);
+
+        if (node.number_of_jobs == 0)
+            return;
+        Time total_time = node.number_of_stations * c;
+        Time idle_time = total_time - node.processing_time_sum;
+        double mean_job_processing_time = (double)node.processing_time_sum
+            / node.number_of_jobs;
+        node.guide = (double)idle_time / total_time
+            / std::pow(mean_job_processing_time, 2);
+    }
+
+    /** Return the jobs of each station of a solution, in the original direction. */
+    std::vector<std::vector<JobId>> solution_stations(
+            const std::shared_ptr<Node>& node) const
+    {
+        std::vector<std::vector<JobId>> stations(node->number_of_stations);
+        for (auto node_tmp = node;
+                node_tmp->parent != nullptr;
+                node_tmp = node_tmp->parent) {
+            if (!reverse_) {
+                stations[node_tmp->number_of_stations - 1] = node_tmp->station_jobs;
+            } else {
+                StationId station_id = node->number_of_stations
+                    - node_tmp->number_of_stations;
+                stations[station_id] = std::vector<JobId>(
+                        node_tmp->station_jobs.rbegin(),
+                        node_tmp->station_jobs.rend());
+            }
+        }
+        return stations;
+    }
+
+    /** Instance. */
+    const Instance& instance_;
+
+    /** Parameters. */
+    Parameters parameters_;
+
+    /** Maximum number of calls of 'add_loads' to select the direction. */
+    static const NodeId maximum_number_of_calls_direction_ = 100000;
+
+    /** Cancellation token of the algorithm currently running. */
+    mutable std::shared_ptr<CancellationToken> cancellation_token_;
+
+    /** 'true' iff the reversed precedence graph is used. */
+    bool reverse_ = false;
+
+    /** Predecessors of each job in the precedence graph used for branching. */
+    std::vector<std::vector<JobId>> predecessors_;
+
+    /** Successors of each job in the precedence graph used for branching. */
+    std::vector<std::vector<JobId>> successors_;
+
+    /** Jobs dominating each job according to the Jackson dominance rule. */
+    std::vector<std::vector<JobId>> dominating_jobs_;
+
+    /*
+     * Temporary structures used when enumerating the loads.
+     */
+
+    /** Jobs of the current load. */
+    mutable std::vector<JobId> load_;
+
+    /** Array indicating for each job, if it belongs to the current load. */
+    mutable std::vector<bool> in_load_;
+
+    /** Array indicating for each job, if it is excluded from the current load. */
+    mutable std::vector<bool> excluded_;
+
+    /** Array indicating for each job, if it is ready in the node being expanded. */
+    mutable std::vector<bool> ready_;
+
+    /** Number of unassigned predecessors with the current load. */
+    mutable std::vector<JobId> number_of_remaining_predecessors_;
+
+    /**
+     * Number of remaining calls of 'add_loads' before the enumeration stops;
+     * -1 if unbounded.
+     */
+    mutable NodeId number_of_remaining_calls_ = -1;
+
+    /** 'true' iff the enumeration of the loads stopped at the maximum. */
+    mutable bool loads_truncated_ = false;
+
+    /** Number of expansions whose loads have been truncated. */
+    mutable NodeId number_of_truncated_expansions_ = 0;
+
+    mutable NodeId node_id_ = 0;
+
+};
+
+
+/**
+ * Generate a random instance.
+ *
+ * Processing times are drawn uniformly in [1, maximum_processing_time].
+ *
+ * Arcs between random pairs of jobs, oriented along a random topological
+ * order, are added until the order strength of the precedence graph, i.e. the
+ * density of its transitive closure, reaches 'order_strength'. The closure
+ * takes n^2 / 8 bytes.
+ */
+inline Instance generate_instance(
+        JobId number_of_jobs,
+        double order_strength,
+        Time cycle_time = 1000,
+        Time maximum_processing_time = 500,
+        uint64_t seed = 0)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<Time> d_processing_time(1, maximum_processing_time);
+
+    InstanceBuilder instance_builder;
+    instance_builder.set_cycle_time(cycle_time);
+    instance_builder.add_jobs(number_of_jobs);
+    for (JobId job_id = 0; job_id < number_of_jobs; ++job_id)
+        instance_builder.set_job_processing_time(job_id, d_processing_time(generator));
+
+    // Topological order.
+    std::vector<JobId> jobs(number_of_jobs);
+    for (JobId job_id = 0; job_id < number_of_jobs; ++job_id)
+        jobs[job_id] = job_id;
+    std::shuffle(jobs.begin(), jobs.end(), generator);
+
+    // Transitive closure, indexed by positions, stored as bitsets.
+    JobPos number_of_words = (number_of_jobs + 63) / 64;
+    std::vector<std::vector<uint64_t>> closure(
+            number_of_jobs,
+            std::vector<uint64_t>(number_of_words, 0));
+    int64_t number_of_pairs = number_of_jobs * (number_of_jobs - 1) / 2;
+    int64_t number_of_related_pairs = 0;
+    int64_t number_of_related_pairs_target = (std::min)(
+            number_of_pairs,
+            (int64_t)std::ceil(order_strength * number_of_pairs));
+
+    // Arcs are drawn lazily, as uniform pairs of positions in the topological
+    // order; the pairs already related are skipped. Each added arc is thus
+    // uniform among the unrelated pairs, as when going through a shuffled
+    // list of all the pairs, without storing the O(n^2) candidate arcs.
+    std::uniform_int_distribution<JobPos> d_pos(0, number_of_jobs - 1);
+    while (number_of_related_pairs < number_of_related_pairs_target) {
+        JobPos pos_1 = d_pos(generator);
+        JobPos pos_2 = d_pos(generator);
+        if (pos_1 == pos_2)
+            continue;
+        if (pos_1 > pos_2)
+            std::swap(pos_1, pos_2);
+        if ((closure[pos_1][pos_2 / 64] >> (pos_2 % 64)) & 1)
+            continue;
+        instance_builder.add_predecessor(jobs[pos_2], jobs[pos_1]);
+
+        // Every job reaching pos_1 now reaches pos_2 and its successors.
+        std::vector<uint64_t> reached = closure[pos_2];
+        reached[pos_2 / 64] |= ((uint64_t)1 << (pos_2 % 64));
+        for (JobPos pos = 0; pos <= pos_1; ++pos) {
+            if (pos != pos_1 && !((closure[pos][pos_1 / 64] >> (pos_1 % 64)) & 1))
+                continue;
+            for (JobPos word = 0; word < number_of_words; ++word) {
+                uint64_t added = reached[word] & ~closure[pos][word];
+                closure[pos][word] |= added;
+                for (; added != 0; added &= added - 1)
+                    number_of_related_pairs++;
+            }
+        }
+    }
+    return instance_builder.build();
+}
+
 }
 }
@@ -56,17 +56,28 @@ inline const GreedyOutput<BranchingScheme> greedy(
     algorithm_formatter.start("Greedy");
     algorithm_formatter.print_header();
 
+    ChildGenerator<BranchingScheme> child_generator(branching_scheme);
+
     auto current_node = branching_scheme.root();
     for (output.number_of_nodes = 1;; ++output.number_of_nodes) {
+
+        // Check time.
+        if (algorithm_formatter.needs_to_end())
+            break;
+
+        algorithm_formatter.update_telemetry(
+                output.number_of_nodes,
+                0,
+                0);
         std::shared_ptr<Node> best_child = nullptr;
-        while (!branching_scheme.infertile(current_node)) {
+        while (!child_generator.infertile(current_node)) {
 
             if (best_child != nullptr
                     && branching_scheme(best_child, current_node))
                 break;
 
             // Get next child.
-            auto child = branching_scheme.next_child(current_node);
+            auto child = child_generator.next_child(current_node);
             if (child == nullptr)
                 continue;
 
@@ -89,6 +100,7 @@ inline const GreedyOutput<BranchingScheme> greedy(
         if (best_child == nullptr)
             break;
 
+        child_generator.release(current_node);
         current_node = best_child;
     }
 
@@ -101,10 +101,14 @@ inline const IterativeBeamSearchOutput<BranchingScheme> iterative_beam_search(
     algorithm_formatter.start("Iterative beam search");
     algorithm_formatter.print_header();
 
+    ChildGenerator<BranchingScheme> child_generator(branching_scheme);
+
     // Initialize q and history.
     auto node_hasher = branching_scheme.node_hasher();
     std::vector<std::shared_ptr<NodeSet<BranchingScheme>>> q(2, nullptr);
     std::vector<std::shared_ptr<NodeMap<BranchingScheme>>> history(2, nullptr);
+    HistoryStatistics* history_statistics = (parameters.history_statistics)?
+        &output.history_statistics: nullptr;
     q[0] = std::shared_ptr<NodeSet<BranchingScheme>>(
             new NodeSet<BranchingScheme>(branching_scheme));
     history[0] = std::shared_ptr<NodeMap<BranchingScheme>>(
@@ -116,6 +120,8 @@ inline const IterativeBeamSearchOutput<BranchingScheme> iterative_beam_search(
     Depth number_of_queues = 2;
 
     for (output.maximum_size_of_the_queue = parameters.minimum_size_of_the_queue;;) {
+        algorithm_formatter.start_span(
+                "q " + std::to_string(output.maximum_size_of_the_queue));
 
         // Initialize queue.
         bool stop = true;
@@ -135,6 +141,7 @@ inline const IterativeBeamSearchOutput<BranchingScheme> iterative_beam_search(
 
                     // Bound.
                     if (branching_scheme.bound(current_node, output.solution_pool.worst())) {
+                        child_generator.release(current_node);
                         current_node = nullptr;
                         continue;
                     }
@@ -147,14 +154,18 @@ inline const IterativeBeamSearchOutput<BranchingScheme> iterative_beam_search(
                 }
 
                 // Get next child.
-                auto child = branching_scheme.next_child(current_node);
+                auto child = child_generator.next_child(current_node);
 
                 if (child != nullptr) {
 
                     output.number_of_nodes++;
+                    algorithm_formatter.update_telemetry(
+                            output.number_of_nodes,
+                            q[current_depth + 1]->size(),
+                            history[current_depth + 1]->size());
 
                     // Check time.
-                    if (parameters.timer.needs_to_end())
+                    if (algorithm_formatter.needs_to_end())
                         goto ibsend;
 
                     // Check node limit.
@@ -209,20 +220,24 @@ inline const IterativeBeamSearchOutput<BranchingScheme> iterative_beam_search(
                                     branching_scheme,
                                     *history[child_depth],
                                     *q[child_depth],
-                                    child);
+                                    child,
+                                    history_statistics,
+                                    &child_generator);
                             //q_next->insert(child);
                             if ((NodeId)q[child_depth]->size() > output.maximum_size_of_the_queue)
                                 remove_from_history_and_queue(
                                         branching_scheme,
                                         *history[child_depth],
                                         *q[child_depth],
-                                        std::prev(q[child_depth]->end()));
+                                        std::prev(q[child_depth]->end()),
+                                        history_statistics,
+                                        &child_generator);
                         }
                     }
                 }
 
                 // If current_node still has children, put it back to the queue.
-                if (branching_scheme.infertile(current_node)) {
+                if (child_generator.infertile(current_node)) {
                     current_node = nullptr;
                 } else if (!q[current_depth]->empty()
                         && branching_scheme(*(q[current_depth]->begin()), current_node)) {
@@ -232,6 +247,12 @@ inline const IterativeBeamSearchOutput<BranchingScheme> iterative_beam_search(
 
             }
 
+            // Release the children of the nodes left at the current depth.
+            if (current_node != nullptr)
+                child_generator.release(current_node);
+            for (const auto& node: *q[current_depth])
+                child_generator.release(node);
+
             // Update q and history.
             if ((Depth)q.size() <= current_depth + number_of_queues) {
                 q.push_back(nullptr);
@@ -267,10 +288,12 @@ inline const IterativeBeamSearchOutput<BranchingScheme> iterative_beam_search(
             q[d]->clear();
             history[d]->clear();
         }
+        child_generator.clear();
 
         std::stringstream ss;
         ss << "q " << output.maximum_size_of_the_queue;
         algorithm_formatter.print(ss);
+        algorithm_formatter.end_span();
 
         // Increase the size of the queue.
         NodeId maximum_size_of_the_queue_next = std::max(
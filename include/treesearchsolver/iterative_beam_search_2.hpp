@@ -123,6 +123,8 @@ inline const IterativeBeamSearch2Output<BranchingScheme> iterative_beam_search_2
     auto node_hasher = branching_scheme.node_hasher();
     std::vector<std::shared_ptr<NodeSet<BranchingScheme>>> q(2, nullptr);
     std::vector<std::shared_ptr<NodeMap<BranchingScheme>>> history(2, nullptr);
+    HistoryStatistics* history_statistics = (parameters.history_statistics)?
+        &output.history_statistics: nullptr;
     q[0] = std::shared_ptr<NodeSet<BranchingScheme>>(
             new NodeSet<BranchingScheme>(branching_scheme));
     history[0] = std::shared_ptr<NodeMap<BranchingScheme>>(
@@ -134,6 +136,8 @@ inline const IterativeBeamSearch2Output<BranchingScheme> iterative_beam_search_2
     Depth number_of_queues = 2;
 
     for (output.maximum_size_of_the_queue = parameters.minimum_size_of_the_queue;;) {
+        algorithm_formatter.start_span(
+                "q " + std::to_string(output.maximum_size_of_the_queue));
 
         // Initialize queue.
         bool stop = true;
@@ -159,7 +163,7 @@ inline const IterativeBeamSearch2Output<BranchingScheme> iterative_beam_search_2
                 }
 
                 // Check time.
-                if (parameters.timer.needs_to_end())
+                if (algorithm_formatter.needs_to_end())
                     goto ibsend;
 
                 // Check best known bound.
@@ -170,11 +174,19 @@ inline const IterativeBeamSearch2Output<BranchingScheme> iterative_beam_search_2
                     goto ibsend;
 
                 // Get next child.
-                auto children = branching_scheme.children(current_node);
+                auto children = generate_children(branching_scheme, current_node);
                 output.number_of_nodes_expanded++;
+                algorithm_formatter.update_telemetry(
+                        output.number_of_nodes_expanded,
+                        q[current_depth + 1]->size(),
+                        history[current_depth + 1]->size());
 
                 for (const auto& child: children) {
 
+                    // Check time, a node may have many children.
+                    if (algorithm_formatter.needs_to_end())
+                        goto ibsend;
+
                     output.number_of_nodes_generated++;
 
                     // Get child depth.
@@ -217,7 +229,8 @@ inline const IterativeBeamSearch2Output<BranchingScheme> iterative_beam_search_2
                                     branching_scheme,
                                     *history[child_depth],
                                     *q[child_depth],
-                                    child);
+                                    child,
+                                    history_statistics);
                             if (added)
                                 output.number_of_nodes_added++;
                             //q_next->insert(child);
@@ -226,7 +239,8 @@ inline const IterativeBeamSearch2Output<BranchingScheme> iterative_beam_search_2
                                         branching_scheme,
                                         *history[child_depth],
                                         *q[child_depth],
-                                        std::prev(q[child_depth]->end()));
+                                        std::prev(q[child_depth]->end()),
+                                        history_statistics);
                             }
                         }
                     }
@@ -283,6 +297,7 @@ inline const IterativeBeamSearch2Output<BranchingScheme> iterative_beam_search_2
         std::stringstream ss;
         ss << "q " << output.maximum_size_of_the_queue;
         algorithm_formatter.print(ss);
+        algorithm_formatter.end_span();
 
         // Increase the size of the queue.
         NodeId maximum_size_of_the_queue_next = std::max(
@@ -101,9 +101,13 @@ inline const IterativeMemoryBoundedBestFirstSearchOutput<BranchingScheme> iterat
     algorithm_formatter.start("Iterative memory bounded best first search");
     algorithm_formatter.print_header();
 
+    ChildGenerator<BranchingScheme> child_generator(branching_scheme);
+
     auto node_hasher = branching_scheme.node_hasher();
     NodeSet<BranchingScheme> q(branching_scheme);
     NodeMap<BranchingScheme> history{0, node_hasher, node_hasher};
+    HistoryStatistics* history_statistics = (parameters.history_statistics)?
+        &output.history_statistics: nullptr;
 
     for (output.maximum_size_of_the_queue = parameters.minimum_size_of_the_queue;;
             output.maximum_size_of_the_queue = output.maximum_size_of_the_queue * parameters.growth_factor) {
@@ -115,18 +119,24 @@ inline const IterativeMemoryBoundedBestFirstSearchOutput<BranchingScheme> iterat
         std::stringstream ss;
         ss << "q " << output.maximum_size_of_the_queue;
         algorithm_formatter.print(ss);
+        algorithm_formatter.start_span(ss.str());
 
         q.clear();
         history.clear();
+        child_generator.clear();
 
         bool stop = true;
         auto node_cur = branching_scheme.root();
 
         while (node_cur != nullptr || !q.empty()) {
             output.number_of_nodes++;
+            algorithm_formatter.update_telemetry(
+                    output.number_of_nodes,
+                    q.size(),
+                    history.size());
 
             // Check time.
-            if (parameters.timer.needs_to_end())
+            if (algorithm_formatter.needs_to_end())
                 goto imbastarend;
 
             // Check node limit.
@@ -143,12 +153,13 @@ inline const IterativeMemoryBoundedBestFirstSearchOutput<BranchingScheme> iterat
 
             // Bound.
             if (branching_scheme.bound(node_cur, output.solution_pool.worst())) {
+                child_generator.release(node_cur);
                 node_cur = nullptr;
                 continue;
             }
 
             // Get next child.
-            auto child = branching_scheme.next_child(node_cur);
+            auto child = child_generator.next_child(node_cur);
             // Bound.
             if (child != nullptr) {
                 // Update best solution.
@@ -164,9 +175,10 @@ inline const IterativeMemoryBoundedBestFirstSearchOutput<BranchingScheme> iterat
                     }
                     if ((Counter)q.size() < output.maximum_size_of_the_queue
                             || branching_scheme(child, *(std::prev(q.end())))) {
-                        add_to_history_and_queue(branching_scheme, history, q, child);
+                        add_to_history_and_queue(branching_scheme, history, q, child, history_statistics, &child_generator);
                         if ((Counter)q.size() > output.maximum_size_of_the_queue) {
                             //remove_from_history_and_queue(branching_scheme, history, q, std::prev(q.end()));
+                            child_generator.release(*std::prev(q.end()));
                             q.erase(std::prev(q.end()));
                         }
                     }
@@ -174,7 +186,7 @@ inline const IterativeMemoryBoundedBestFirstSearchOutput<BranchingScheme> iterat
             }
 
             // If node_cur still has children, put it back to the queue.
-            if (branching_scheme.infertile(node_cur)) {
+            if (child_generator.infertile(node_cur)) {
                 node_cur = nullptr;
             } else if ((Counter)q.size() != 0
                     && branching_scheme(*(q.begin()), node_cur)) {
@@ -184,11 +196,13 @@ inline const IterativeMemoryBoundedBestFirstSearchOutput<BranchingScheme> iterat
                 if ((Counter)q.size() > output.maximum_size_of_the_queue) {
                     stop = false;
                     //remove_from_history_and_queue(branching_scheme, history, q, std::prev(q.end()));
+                    child_generator.release(*std::prev(q.end()));
                     q.erase(std::prev(q.end()));
                 }
             }
 
         }
+        algorithm_formatter.end_span();
         if (stop)
             break;
     }
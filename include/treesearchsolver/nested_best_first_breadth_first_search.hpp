@@ -87,6 +87,8 @@ inline const NestedBestFirstBreadthFirstSearchOutput<BranchingScheme> nested_bes
 
     auto node_hasher = branching_scheme.node_hasher();
     NodeMap<BranchingScheme> history{0, node_hasher, node_hasher};
+    HistoryStatistics* history_statistics = (parameters.history_statistics)?
+        &output.history_statistics: nullptr;
     NodeSet<BranchingScheme> q(branching_scheme);
 
     q.insert(branching_scheme.root());
@@ -94,7 +96,7 @@ inline const NestedBestFirstBreadthFirstSearchOutput<BranchingScheme> nested_bes
     while (!q.empty()) {
 
         // Check time.
-        if (parameters.timer.needs_to_end())
+        if (algorithm_formatter.needs_to_end())
             break;
 
         // Check node limit.
@@ -131,6 +133,10 @@ inline const NestedBestFirstBreadthFirstSearchOutput<BranchingScheme> nested_bes
 
             output.number_of_nodes++;
             brfs_number_of_nodes++;
+            algorithm_formatter.update_telemetry(
+                    output.number_of_nodes,
+                    q.size(),
+                    history.size());
             if (brfs_number_of_nodes > 1e5)
                 break;
 
@@ -139,14 +145,7 @@ inline const NestedBestFirstBreadthFirstSearchOutput<BranchingScheme> nested_bes
             brfs_q.pop();
 
             // Generate children.
-            while (!branching_scheme.infertile(brfs_current_node)) {
-
-                // Get next child.
-                auto brfs_child = branching_scheme.next_child(brfs_current_node);
-
-                // Bound.
-                if (brfs_child == nullptr)
-                    continue;
+            for (const auto& brfs_child: generate_children(branching_scheme, brfs_current_node)) {
 
                 // Update best solution.
                 if (branching_scheme.better(brfs_child, output.solution_pool.worst())) {
@@ -164,7 +163,7 @@ inline const NestedBestFirstBreadthFirstSearchOutput<BranchingScheme> nested_bes
                 if (branching_scheme.bound(brfs_child, output.solution_pool.worst()))
                     continue;
 
-                bool added = add_to_history_and_queue(branching_scheme, history, q, brfs_child);
+                bool added = add_to_history_and_queue(branching_scheme, history, q, brfs_child, history_statistics);
                 if (added)
                     brfs_q.push(brfs_child);
             }
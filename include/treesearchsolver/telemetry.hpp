@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace treesearchsolver
+{
+
+enum class TelemetryFormat { Prometheus, JsonLines };
+
+std::istream& operator>>(
+        std::istream& in,
+        TelemetryFormat& format);
+
+std::ostream& operator<<(
+        std::ostream& os,
+        TelemetryFormat format);
+
+/**
+ * Counters read by the telemetry reporter.
+ *
+ * They are written by the search thread and read by the reporter thread with
+ * relaxed atomics, so updating them doesn't synchronize the two threads.
+ */
+struct TelemetryCounters
+{
+    /** Number of nodes. */
+    std::atomic<int64_t> number_of_nodes;
+
+    /** Size of the queue. */
+    std::atomic<int64_t> queue_size;
+
+    /**
+     * Number of keys of the history, i.e. of distinct states.
+     *
+     * A key may hold several nodes, so this is not the number of nodes of the
+     * history.
+     */
+    std::atomic<int64_t> history_number_of_keys;
+
+    /** Value of the best solution found. */
+    std::atomic<double> best_value;
+};
+
+/**
+ * Class that writes periodically a snapshot of the search metrics to a file.
+ *
+ * In the Prometheus text exposition format, the file is overwritten at each
+ * snapshot. In the JSON Lines format, a line is appended at each snapshot.
+ */
+class TelemetryReporter
+{
+
+public:
+
+    /** Constructor. */
+    TelemetryReporter(
+            const std::string& algorithm_name,
+            const std::string& telemetry_path,
+            TelemetryFormat format,
+            double period,
+            int64_t node_size);
+
+    /** Destructor. */
+    ~TelemetryReporter() { stop(); }
+
+    /** Get the counters. */
+    TelemetryCounters& counters() { return counters_; }
+
+    /** Update the counters. */
+    inline void update(
+            int64_t number_of_nodes,
+            int64_t queue_size,
+            int64_t history_number_of_keys)
+    {
+        counters_.number_of_nodes.store(number_of_nodes, std::memory_order_relaxed);
+        counters_.queue_size.store(queue_size, std::memory_order_relaxed);
+        counters_.history_number_of_keys.store(history_number_of_keys, std::memory_order_relaxed);
+    }
+
+    /** Start the reporter thread. */
+    void start();
+
+    /** Write a last snapshot and stop the reporter thread. */
+    void stop();
+
+private:
+
+    /** Write a snapshot. */
+    void write_snapshot();
+
+    /** Name of the algorithm. */
+    std::string algorithm_name_;
+
+    /** Path of the telemetry file. */
+    std::string telemetry_path_;
+
+    /** Format of the telemetry file. */
+    TelemetryFormat format_;
+
+    /** Period between two snapshots in milliseconds. */
+    double period_;
+
+    /** Size of a node, used to estimate the memory usage. */
+    int64_t node_size_;
+
+    /** Counters. */
+    TelemetryCounters counters_;
+
+    /** Start time. */
+    std::chrono::steady_clock::time_point start_;
+
+    /** Time of the previous snapshot. */
+    double previous_time_ = 0;
+
+    /** Number of nodes at the previous snapshot. */
+    int64_t previous_number_of_nodes_ = 0;
+
+    /** Reporter thread. */
+    std::thread thread_;
+
+    /** Mutex used to wake up the reporter thread. */
+    std::mutex mutex_;
+
+    /** Condition variable used to wake up the reporter thread. */
+    std::condition_variable condition_variable_;
+
+    /** True if the reporter thread needs to stop. */
+    bool stop_ = false;
+
+};
+
+}
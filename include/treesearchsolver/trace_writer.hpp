@@ -0,0 +1,79 @@
+#pragma once
+
+#include "treesearchsolver/common.hpp"
+
+#include <string>
+#include <vector>
+
+namespace treesearchsolver
+{
+
+/**
+ * Class to record a timeline of the search in the Chrome trace-event format.
+ *
+ * Events are buffered in memory and only written to the file when 'write' is
+ * called, so that recording them doesn't perturb the search.
+ *
+ * The resulting file can be opened with chrome://tracing or Perfetto.
+ */
+class TraceWriter
+{
+
+public:
+
+    /** Constructor. */
+    TraceWriter(const std::string& trace_path):
+        trace_path_(trace_path) { }
+
+    /** Start a span. */
+    void begin(
+            const std::string& name,
+            double time,
+            const nlohmann::json& arguments = nlohmann::json::object());
+
+    /** End the last started span. */
+    void end(
+            double time,
+            const nlohmann::json& arguments = nlohmann::json::object());
+
+    /** Add an instant event. */
+    void instant(
+            const std::string& name,
+            double time,
+            const nlohmann::json& arguments = nlohmann::json::object());
+
+    /** Get the number of spans started and not ended yet. */
+    Counter number_of_open_spans() const { return open_spans_.size(); }
+
+    /** Write the trace file. */
+    void write() const;
+
+private:
+
+    struct Event
+    {
+        /** Phase ('B', 'E' or 'i'). */
+        char phase;
+
+        /** Name. */
+        std::string name;
+
+        /** Timestamp in microseconds. */
+        double timestamp;
+
+        /** Arguments. */
+        nlohmann::json arguments;
+    };
+
+    /** Path of the trace file. */
+    std::string trace_path_;
+
+    /** Events. */
+    std::vector<Event> events_;
+
+    /** Names of the spans started and not ended yet. */
+    std::vector<std::string> open_spans_;
+
+};
+
+}
@@ -0,0 +1,117 @@
+import argparse
+import json
+import os
+import re
+import statistics
+
+
+parser = argparse.ArgumentParser(
+        description='Aggregate the anytime profiles of JSON outputs. '
+        'Outputs are grouped by their directory relative to each root, '
+        'e.g. EXAMPLE/ALGORITHM for the outputs of run_benchmarks.py.')
+parser.add_argument(
+        'roots',
+        nargs='+',
+        help='directories containing JSON outputs (one group per root with --by-root)')
+parser.add_argument(
+        "--by-root",
+        action='store_true',
+        help='group the outputs by root instead of by directory, e.g. to '
+        'compare parameter settings run in different directories')
+parser.add_argument(
+        "--target-gap",
+        type=float,
+        default=None,
+        help='recompute the time to target from the intermediary outputs '
+        'with this target gap')
+args = parser.parse_args()
+
+
+def primal_gap(value, reference_value):
+    if value == reference_value:
+        return 0.0
+    if value * reference_value < 0:
+        return 1.0
+    return abs(reference_value - value) / max(abs(reference_value), abs(value))
+
+
+# Number at the beginning of a displayed value, e.g. "123 (n4/50 w90/100)".
+leading_number = re.compile(
+        r"\s*[-+]?(\d+\.?\d*|\.\d+)([eE][-+]?\d+)?|\s*[-+]?(inf|nan)",
+        re.IGNORECASE)
+
+
+def numeric_value(output):
+    """Return the value of an output as a number, or None if it has no
+    solution."""
+    if "NumericValue" in output:
+        return output["NumericValue"]
+    # Outputs written before NumericValue existed: parse the displayed value
+    # as the C++ 'value' fallback does.
+    match = leading_number.match(output["Value"])
+    if match is None:
+        return None
+    return float(match.group(0))
+
+
+def read_profile(path):
+    with open(path, "r") as f:
+        json_output = json.load(f)
+    if "Output" not in json_output:
+        return None
+    profile = json_output["Output"].get("AnytimeProfile")
+    if profile is None:
+        return None
+    if args.target_gap is not None:
+        profile["TimeToTarget"] = -1
+        for intermediary_output in json_output.get("IntermediaryOutputs", []):
+            value = numeric_value(intermediary_output)
+            if value is None:
+                continue
+            if primal_gap(value, profile["ReferenceValue"]) <= args.target_gap:
+                profile["TimeToTarget"] = intermediary_output["Time"]
+                break
+    return profile
+
+
+groups = {}
+for root in args.roots:
+    for directory, _, filenames in os.walk(root):
+        for filename in filenames:
+            if not filename.endswith(".json"):
+                continue
+            path = os.path.join(directory, filename)
+            profile = read_profile(path)
+            if profile is None:
+                continue
+            if args.by_root:
+                group = root
+            else:
+                group = os.path.relpath(directory, root)
+            groups.setdefault(group, []).append(profile)
+
+print("{:<56}{:>6}{:>14}{:>14}{:>14}{:>10}{:>14}".format(
+    "Group",
+    "Runs",
+    "PI (mean)",
+    "PI (median)",
+    "TTFS (mean)",
+    "Targets",
+    "TTT (mean)"))
+for group in sorted(groups):
+    profiles = groups[group]
+    primal_integrals = [p["PrimalIntegral"] for p in profiles]
+    times_to_first_solution = [
+            p["TimeToFirstSolution"] for p in profiles
+            if p["TimeToFirstSolution"] >= 0]
+    times_to_target = [
+            p["TimeToTarget"] for p in profiles
+            if p["TimeToTarget"] >= 0]
+    print("{:<56}{:>6}{:>14.6f}{:>14.6f}{:>14.6f}{:>10}{:>14}".format(
+        group[:55],
+        len(profiles),
+        statistics.mean(primal_integrals),
+        statistics.median(primal_integrals),
+        statistics.mean(times_to_first_solution) if times_to_first_solution else float("nan"),
+        str(len(times_to_target)) + "/" + str(len(profiles)),
+        "{:.6f}".format(statistics.mean(times_to_target)) if times_to_target else "-"))
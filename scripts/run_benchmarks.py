@@ -0,0 +1,240 @@
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+
+# Algorithms run on every example. Every main accepts all of them, whether its
+# branching scheme provides 'next_child', 'children' or both.
+algorithms = [
+        "greedy",
+        "best-first-search",
+        "best-first-search-2",
+        "iterative-beam-search",
+        "iterative-beam-search-2",
+        "anytime-column-search",
+        "iterative-memory-bounded-best-first-search"]
+
+# Example name -> (main, data environment variable, instances, algorithms).
+examples = {
+        "knapsack-with-conflicts": (
+            "treesearchsolver_knapsack_with_conflicts",
+            "KNAPSACK_WITH_CONFLICTS_DATA",
+            [
+                (os.path.join("hifi2006", "I1 - I10", "1I1"), "hifi2006"),
+                (os.path.join("hifi2006", "I1 - I10", "5I5"), "hifi2006"),
+                (os.path.join("hifi2006", "I1 - I10", "10I5"), "hifi2006")],
+            algorithms),
+        "permutation-flowshop-scheduling-tct": (
+            "treesearchsolver_permutation_flowshop_scheduling_tct",
+            "FLOWSHOP_SCHEDULING_DATA",
+            [
+                (os.path.join("taillard1993", "tai20_5_0.txt"), "default"),
+                (os.path.join("taillard1993", "tai20_5_5.txt"), "default"),
+                (os.path.join("taillard1993", "tai20_5_9.txt"), "default")],
+            algorithms),
+        "permutation-flowshop-scheduling-makespan": (
+            "treesearchsolver_permutation_flowshop_scheduling_makespan",
+            "FLOWSHOP_SCHEDULING_DATA",
+            [
+                (os.path.join("vallada2015", "Small", "VFR10_5_1_Gap.txt"), "default"),
+                (os.path.join("vallada2015", "Small", "VFR10_5_5_Gap.txt"), "default"),
+                (os.path.join("vallada2015", "Small", "VFR10_5_10_Gap.txt"), "default")],
+            algorithms),
+        "sequential-ordering-problem": (
+            "treesearchsolver_sequential_ordering",
+            "SEQUENTIAL_ORDERING_DATA",
+            [
+                (os.path.join("soplib", "R.200.100.1.sop"), "soplib"),
+                (os.path.join("soplib", "R.200.100.30.sop"), "soplib"),
+                (os.path.join("soplib", "R.200.1000.60.sop"), "soplib")],
+            algorithms),
+        "simple-assembly-line-balancing-1": (
+            "treesearchsolver_simple_assembly_line_balancing_1",
+            "SIMPLE_ASSEMBLY_LINE_BALANCING_1_DATA",
+            [
+                (os.path.join("otto2013", "medium data set_n=50", "instance_n=50_50.alb"), "otto2013"),
+                (os.path.join("otto2013", "medium data set_n=50", "instance_n=50_250.alb"), "otto2013"),
+                (os.path.join("otto2013", "medium data set_n=50", "instance_n=50_500.alb"), "otto2013")],
+            algorithms),
+        }
+
+
+def run(main, instance_path, instance_format, algorithm, json_output_path):
+    """Run a main and return its wall time, peak RSS and JSON output."""
+    command = [
+            main,
+            "--verbosity-level", "0",
+            "--input", instance_path,
+            "--format", instance_format,
+            "--algorithm", algorithm,
+            "--maximum-number-of-nodes", str(args.maximum_number_of_nodes),
+            "--only-write-at-the-end",
+            "--output", json_output_path]
+    if algorithm == "anytime-column-search":
+        command += ["--initial-column-size", "1"]
+    print(" ".join("\"" + c + "\"" if " " in c else c for c in command))
+    start = time.perf_counter()
+    process = subprocess.Popen(command, stdout=subprocess.DEVNULL)
+    _, status, rusage = os.wait4(process.pid, 0)
+    wall_time = time.perf_counter() - start
+    process.returncode = os.waitstatus_to_exitcode(status)
+    if process.returncode != 0:
+        sys.exit(1)
+    with open(json_output_path, "r") as f:
+        output = json.load(f)["Output"]
+    # ru_maxrss is in kilobytes on Linux.
+    return wall_time, rusage.ru_maxrss * 1024, output
+
+
+def run_suite():
+    results = []
+    for example, (main, data_env, data, example_algorithms) in examples.items():
+        if args.tests is not None and example not in args.tests:
+            continue
+        data_dir = os.environ[data_env]
+        main = os.path.join("install", "bin", main)
+        for instance, instance_format in data:
+            instance_path = os.path.join(data_dir, instance)
+            for algorithm in example_algorithms:
+                if args.algorithms is not None and algorithm not in args.algorithms:
+                    continue
+                json_output_path = os.path.join(
+                        args.directory,
+                        example,
+                        algorithm,
+                        instance + ".json")
+                if not os.path.exists(os.path.dirname(json_output_path)):
+                    os.makedirs(os.path.dirname(json_output_path))
+
+                # Keep the fastest of the repetitions.
+                wall_time = None
+                peak_rss = 0
+                for _ in range(args.repetitions):
+                    t, rss, output = run(
+                            main,
+                            instance_path,
+                            instance_format,
+                            algorithm,
+                            json_output_path)
+                    if wall_time is None or t < wall_time:
+                        wall_time = t
+                    peak_rss = max(peak_rss, rss)
+
+                number_of_nodes = output.get(
+                        "NumberOfNodes",
+                        output.get("NumberOfNodesExpanded", 0))
+                results.append({
+                    "Example": example,
+                    "Instance": instance,
+                    "Algorithm": algorithm,
+                    "WallTime": wall_time,
+                    "NumberOfNodes": number_of_nodes,
+                    "NodesPerSecond": number_of_nodes / wall_time if wall_time > 0 else 0,
+                    "PeakRss": peak_rss,
+                    "Value": output["Value"],
+                    "PrimalIntegral": output.get("AnytimeProfile", {}).get("PrimalIntegral"),
+                    "TimeToFirstSolution": output.get("AnytimeProfile", {}).get("TimeToFirstSolution")})
+    return results
+
+
+def compare(results, reference_results):
+    """Compare results against a reference report and return the number of
+    regressions."""
+    reference = {
+            (r["Example"], r["Instance"], r["Algorithm"]): r
+            for r in reference_results}
+    number_of_regressions = 0
+    print()
+    print("{:<44}{:<16}{:>12}{:>12}{:>10}".format(
+        "Example / Instance", "Algorithm", "Reference", "Current", "Ratio"))
+    for r in results:
+        key = (r["Example"], r["Instance"], r["Algorithm"])
+        if key not in reference:
+            continue
+        ref = reference[key]
+        ratio = r["WallTime"] / ref["WallTime"] if ref["WallTime"] > 0 else 1.0
+        flags = []
+        if ratio > 1.0 + args.threshold:
+            flags.append("SLOWER")
+            number_of_regressions += 1
+        if r["Value"] != ref["Value"]:
+            flags.append("VALUE " + str(ref["Value"]) + " -> " + str(r["Value"]))
+        if r["NumberOfNodes"] != ref["NumberOfNodes"]:
+            flags.append("NODES " + str(ref["NumberOfNodes"]) + " -> " + str(r["NumberOfNodes"]))
+        print("{:<44}{:<16}{:>12.4f}{:>12.4f}{:>10.3f}  {}".format(
+            (r["Example"] + " / " + os.path.basename(r["Instance"]))[:43],
+            r["Algorithm"][:15],
+            ref["WallTime"],
+            r["WallTime"],
+            ratio,
+            " ".join(flags)))
+    print()
+    print("Number of regressions: " + str(number_of_regressions))
+    return number_of_regressions
+
+
+parser = argparse.ArgumentParser(
+        description='Run every algorithm on every example under a node limit '
+        'and record wall time, nodes per second, peak RSS and value.')
+parser.add_argument('directory')
+parser.add_argument(
+        "-t", "--tests",
+        type=str,
+        nargs='*',
+        help='examples to run')
+parser.add_argument(
+        "-a", "--algorithms",
+        type=str,
+        nargs='*',
+        help='algorithms to run')
+parser.add_argument(
+        "-n", "--maximum-number-of-nodes",
+        type=int,
+        default=100000,
+        help='node limit of each run')
+parser.add_argument(
+        "-r", "--repetitions",
+        type=int,
+        default=1,
+        help='number of runs of each test, the fastest one is kept')
+parser.add_argument(
+        "-o", "--report",
+        type=str,
+        default=None,
+        help='path of the JSON report (default: DIRECTORY/report.json)')
+parser.add_argument(
+        "--ref",
+        type=str,
+        default=None,
+        help='reference JSON report to compare against')
+parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help='relative slowdown above which a test is flagged')
+
+args = parser.parse_args()
+
+# Read the reference first since it may be overwritten by the report.
+reference_results = None
+if args.ref is not None:
+    with open(args.ref, "r") as f:
+        reference_results = json.load(f)["Results"]
+
+results = run_suite()
+
+report_path = args.report
+if report_path is None:
+    report_path = os.path.join(args.directory, "report.json")
+with open(report_path, "w") as f:
+    json.dump({
+        "MaximumNumberOfNodes": args.maximum_number_of_nodes,
+        "Results": results}, f, indent=4)
+print("Report written in " + report_path)
+
+if reference_results is not None:
+    if compare(results, reference_results) > 0:
+        sys.exit(1)
@@ -0,0 +1,134 @@
+#include "treesearchsolver/cancellation_token.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <limits>
+
+using namespace treesearchsolver;
+
+namespace
+{
+
+/** Maximum number of tokens cancelled on SIGINT. */
+const int maximum_number_of_sigint_tokens = 256;
+
+/** Tokens of the running algorithms, cancelled on SIGINT. */
+std::atomic<CancellationToken*> sigint_tokens[maximum_number_of_sigint_tokens];
+
+/** Time of the first SIGINT, in ticks of the steady clock, 0 if none. */
+std::atomic<int64_t> sigint_time(0);
+
+/** Number of SIGINT handlers running. */
+std::atomic<int> number_of_running_sigint_handlers(0);
+
+void sigint_handler(int)
+{
+    // A second SIGINT terminates the process.
+    if (sigint_time.load() != 0) {
+        std::signal(SIGINT, SIG_DFL);
+        std::raise(SIGINT);
+        return;
+    }
+
+    // 'clock_gettime', used by the steady clock, is async-signal-safe.
+    number_of_running_sigint_handlers++;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    sigint_time.store(now.time_since_epoch().count());
+    for (int pos = 0; pos < maximum_number_of_sigint_tokens; ++pos) {
+        CancellationToken* cancellation_token = sigint_tokens[pos].load();
+        if (cancellation_token != nullptr)
+            cancellation_token->cancel(now);
+    }
+    number_of_running_sigint_handlers--;
+}
+
+}
+
+void treesearchsolver::set_sigint_handler()
+{
+    std::signal(SIGINT, sigint_handler);
+}
+
+double CancellationToken::time_since_cancellation() const
+{
+    if (!cancelled_.load(std::memory_order_acquire))
+        return std::numeric_limits<double>::quiet_NaN();
+    std::chrono::steady_clock::duration cancellation_time(
+            cancellation_time_.load(std::memory_order_relaxed));
+    return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()
+            - cancellation_time).count();
+}
+
+void DeadlineWatcher::start()
+{
+    // Without time limit, the remaining time is infinite. Time limits of more
+    // than 30 years are treated the same way so that the deadline doesn't
+    // overflow.
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point deadline
+        = std::chrono::steady_clock::time_point::max();
+    double remaining_time = timer_.remaining_time();
+    if (remaining_time < 1e9) {
+        deadline = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(remaining_time));
+    }
+    std::chrono::steady_clock::duration period
+        = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::milli>(
+                    (std::min)(period_, 1e12)));
+
+    // Register the token to be cancelled on SIGINT. If all the positions are
+    // taken, the token is only cancelled by the timer.
+    for (int pos = 0; pos < maximum_number_of_sigint_tokens; ++pos) {
+        CancellationToken* expected = nullptr;
+        if (sigint_tokens[pos].compare_exchange_strong(
+                    expected,
+                    &cancellation_token_)) {
+            sigint_token_pos_ = pos;
+            break;
+        }
+    }
+    if (sigint_time.load() != 0)
+        cancellation_token_.cancel();
+
+    thread_ = std::thread([this, deadline, period]()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            std::chrono::steady_clock::time_point now
+                = std::chrono::steady_clock::now();
+            if (now >= deadline || timer_.needs_to_end()) {
+                // If the time limit is reached, the stop latency is measured
+                // from the deadline, so it includes the wake-up delay of the
+                // watcher.
+                cancellation_token_.cancel((std::min)(now, deadline));
+                break;
+            }
+            condition_variable_.wait_until(
+                    lock,
+                    (deadline - now < period)? deadline: now + period);
+        }
+    });
+}
+
+void DeadlineWatcher::stop()
+{
+    if (!thread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_variable_.notify_one();
+    thread_.join();
+
+    // Unregister the token, and wait for the SIGINT handlers which may still
+    // use it.
+    if (sigint_token_pos_ != -1) {
+        sigint_tokens[sigint_token_pos_].store(nullptr);
+        sigint_token_pos_ = -1;
+        while (number_of_running_sigint_handlers.load() > 0)
+            std::this_thread::yield();
+    }
+}
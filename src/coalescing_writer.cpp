@@ -0,0 +1,77 @@
+#include "treesearchsolver/coalescing_writer.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+
+using namespace treesearchsolver;
+
+CoalescingWriter::CoalescingWriter()
+{
+    thread_ = std::thread([this]()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            condition_variable_.wait(
+                    lock,
+                    [this]() { return stop_ || pending_write_; });
+            if (!pending_write_)
+                break;
+            Write write;
+            write.swap(pending_write_);
+            // Write without holding the lock so that the search thread can
+            // submit a new snapshot meanwhile.
+            lock.unlock();
+            try {
+                write();
+            } catch (const std::exception& e) {
+                std::cerr << "Unable to write snapshot: " << e.what() << std::endl;
+            }
+            lock.lock();
+            number_of_snapshots_written_++;
+        }
+    });
+}
+
+void CoalescingWriter::submit(Write write)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_)
+            return;
+        if (pending_write_)
+            number_of_snapshots_dropped_++;
+        pending_write_.swap(write);
+    }
+    condition_variable_.notify_one();
+}
+
+void CoalescingWriter::stop()
+{
+    if (!thread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_variable_.notify_one();
+    thread_.join();
+}
+
+void treesearchsolver::write_atomically(
+        const std::string& path,
+        const std::function<void(const std::string&)>& write)
+{
+    if (path.empty())
+        return;
+    std::string tmp_path = path + ".tmp";
+    write(tmp_path);
+#ifdef _WIN32
+    // 'rename' doesn't overwrite existing files on Windows.
+    std::remove(path.c_str());
+#endif
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error(
+                "Unable to rename file \"" + tmp_path + "\" to \"" + path + "\".");
+    }
+}
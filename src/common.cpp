@@ -1,3 +1,120 @@
 #include "treesearchsolver/common.hpp"
 
+#include <algorithm>
+
 using namespace treesearchsolver;
+
+void HistoryStatistics::add_lookup(std::size_t list_length)
+{
+    number_of_lookups++;
+    std::size_t k = 0;
+    while (list_length > 0) {
+        list_length >>= 1;
+        k++;
+    }
+    if (list_length_histogram.size() <= k)
+        list_length_histogram.resize(k + 1, 0);
+    list_length_histogram[k]++;
+}
+
+nlohmann::json HistoryStatistics::to_json() const
+{
+    return {
+        {"NumberOfLookups", number_of_lookups},
+        {"ListLengthHistogram", list_length_histogram},
+        {"NumberOfDominanceChecks", number_of_dominance_checks},
+        {"NumberOfDominatedNodes", number_of_dominated_nodes},
+        {"NumberOfEvictedNodes", number_of_evicted_nodes},
+        {"NumberOfBucketCollisions", number_of_bucket_collisions},
+        {"NumberOfHashCollisions", number_of_hash_collisions}};
+}
+
+void HistoryStatistics::format(
+        std::ostream& os,
+        int width) const
+{
+    os
+        << std::setw(width) << std::left << "History lookups: " << number_of_lookups << std::endl
+        << std::setw(width) << std::left << "History list lengths: ";
+    for (std::size_t k = 0; k < list_length_histogram.size(); ++k) {
+        if (k == 0) {
+            os << "0:" << list_length_histogram[k];
+        } else {
+            os << " <" << ((Counter)1 << k) << ":" << list_length_histogram[k];
+        }
+    }
+    os << std::endl
+        << std::setw(width) << std::left << "Dominance checks: " << number_of_dominance_checks << std::endl
+        << std::setw(width) << std::left << "Dominated nodes: " << number_of_dominated_nodes << std::endl
+        << std::setw(width) << std::left << "Evicted nodes: " << number_of_evicted_nodes << std::endl
+        << std::setw(width) << std::left << "Bucket collision rate: " << (double)number_of_bucket_collisions / number_of_lookups << std::endl
+        << std::setw(width) << std::left << "Hash collision rate: " << (double)number_of_hash_collisions / number_of_lookups << std::endl
+        ;
+}
+
+double treesearchsolver::primal_gap(
+        Value value,
+        Value reference_value)
+{
+    if (value == reference_value)
+        return 0.0;
+    if (value * reference_value < 0)
+        return 1.0;
+    return std::abs(reference_value - value)
+        / std::max(std::abs(reference_value), std::abs(value));
+}
+
+AnytimeProfile treesearchsolver::compute_anytime_profile(
+        const std::vector<std::pair<double, Value>>& solutions,
+        double end_time,
+        Value reference_value,
+        double target_gap)
+{
+    AnytimeProfile anytime_profile;
+    anytime_profile.target_gap = target_gap;
+    anytime_profile.number_of_solutions = solutions.size();
+    if (solutions.empty())
+        return anytime_profile;
+    if (std::isnan(reference_value))
+        reference_value = solutions.back().second;
+    anytime_profile.reference_value = reference_value;
+    anytime_profile.time_to_first_solution = solutions.front().first;
+
+    // The primal gap is a step function, equal to 1 before the first
+    // solution.
+    double time_prev = 0.0;
+    double gap_prev = 1.0;
+    for (const auto& solution: solutions) {
+        anytime_profile.primal_integral += gap_prev * (solution.first - time_prev);
+        time_prev = solution.first;
+        gap_prev = primal_gap(solution.second, reference_value);
+        if (anytime_profile.time_to_target == -1
+                && gap_prev <= target_gap) {
+            anytime_profile.time_to_target = solution.first;
+        }
+    }
+    anytime_profile.primal_integral += gap_prev * std::max(0.0, end_time - time_prev);
+    return anytime_profile;
+}
+
+nlohmann::json AnytimeProfile::to_json() const
+{
+    return {
+        {"NumberOfSolutions", number_of_solutions},
+        {"ReferenceValue", reference_value},
+        {"TargetGap", target_gap},
+        {"TimeToFirstSolution", time_to_first_solution},
+        {"TimeToTarget", time_to_target},
+        {"PrimalIntegral", primal_integral}};
+}
+
+void AnytimeProfile::format(
+        std::ostream& os,
+        int width) const
+{
+    os
+        << std::setw(width) << std::left << "Time to first solution: " << time_to_first_solution << std::endl
+        << std::setw(width) << std::left << "Time to target: " << time_to_target << std::endl
+        << std::setw(width) << std::left << "Primal integral: " << primal_integral << std::endl
+        ;
+}
@@ -0,0 +1,29 @@
+#include "treesearchsolver/event_writer.hpp"
+
+using namespace treesearchsolver;
+
+EventWriter::EventWriter(
+        const std::string& events_path):
+    events_path_(events_path),
+    file_(events_path)
+{
+    if (!file_.good()) {
+        throw std::runtime_error(
+                "Unable to open file \"" + events_path_ + "\".");
+    }
+}
+
+void EventWriter::write(
+        const std::string& event,
+        double time,
+        const nlohmann::json& data)
+{
+    nlohmann::json json = {
+        {"Event", event},
+        {"Time", time}};
+    json.update(data);
+    // Flush each line so that a reader following the file sees the events
+    // as they occur.
+    file_ << json.dump() << std::endl;
+    number_of_events_++;
+}
@@ -4,26 +4,9 @@
 using namespace treesearchsolver;
 using namespace knapsack_with_conflicts;
 
-int main(int argc, char *argv[])
+nlohmann::json solve(
+        const boost::program_options::variables_map& vm)
 {
-    // Setup options.
-    boost::program_options::options_description desc = setup_args();
-    desc.add_options()
-        ("guide,g", boost::program_options::value<GuideId>(), "")
-        ;
-    boost::program_options::variables_map vm;
-    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
-    if (vm.count("help")) {
-        std::cout << desc << std::endl;;
-        throw "";
-    }
-    try {
-        boost::program_options::notify(vm);
-    } catch (const boost::program_options::required_option& e) {
-        std::cout << desc << std::endl;;
-        throw "";
-    }
-
     // Create instance.
     InstanceBuilder instance_builder;
     instance_builder.read(
@@ -35,6 +18,10 @@ int main(int argc, char *argv[])
     BranchingScheme::Parameters parameters;
     if (vm.count("guide"))
         parameters.guide_id = vm["guide"].as<GuideId>();
+    if (vm.count("canonical"))
+        parameters.canonical = vm["canonical"].as<bool>();
+    if (vm.count("bound"))
+        parameters.bound_id = vm["bound"].as<BoundId>();
     BranchingScheme branching_scheme(instance, parameters);
 
     // Run algorithm.
@@ -44,11 +31,18 @@ int main(int argc, char *argv[])
         run_greedy(branching_scheme, vm):
         (algorithm == "best-first-search")?
         run_best_first_search(branching_scheme, vm):
+        (algorithm == "best-first-search-2")?
+        run_best_first_search_2(branching_scheme, vm):
         (algorithm == "iterative-beam-search")?
         run_iterative_beam_search(branching_scheme, vm):
+        (algorithm == "iterative-beam-search-2")?
+        run_iterative_beam_search_2(branching_scheme, vm):
         (algorithm == "anytime-column-search")?
         run_anytime_column_search(branching_scheme, vm):
-        run_iterative_memory_bounded_best_first_search(branching_scheme, vm);
+        (algorithm == "iterative-memory-bounded-best-first-search")?
+        run_iterative_memory_bounded_best_first_search(branching_scheme, vm):
+        throw std::invalid_argument(
+                "Unknown algorithm \"" + algorithm + "\".");
 
     // Run checker.
     if (vm["print-checker"].as<int>() > 0
@@ -62,5 +56,39 @@ int main(int argc, char *argv[])
                 vm["print-checker"].as<int>());
     }
 
+    return output.json["Output"];
+}
+
+int main(int argc, char *argv[])
+{
+    // Setup options.
+    boost::program_options::options_description desc = setup_args();
+    desc.add_options()
+        ("guide,g", boost::program_options::value<GuideId>(), "")
+        ("canonical", boost::program_options::value<bool>(), "only add items ranked after the last added item in efficiency order")
+        ("bound", boost::program_options::value<BoundId>(), "set bound (0: remaining profit, 1: fractional relaxation)")
+        ;
+    boost::program_options::variables_map vm;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    try {
+        boost::program_options::notify(vm);
+    } catch (const boost::program_options::required_option& e) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    if (!vm.count("input") && !vm.count("batch")) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    check_algorithm(vm);
+
+    if (vm.count("batch"))
+        return run_batch(vm, solve);
+    solve(vm);
+
     return 0;
 }
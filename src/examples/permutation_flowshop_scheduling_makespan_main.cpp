@@ -4,27 +4,9 @@
 using namespace treesearchsolver;
 using namespace permutation_flowshop_scheduling_makespan;
 
-int main(int argc, char *argv[])
+nlohmann::json solve(
+        const boost::program_options::variables_map& vm)
 {
-    // Setup options.
-    boost::program_options::options_description desc = setup_args();
-    desc.add_options()
-        ("bidirectional,b", boost::program_options::value<bool>(), "")
-        ("guide,g", boost::program_options::value<GuideId>(), "")
-        ;
-    boost::program_options::variables_map vm;
-    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
-    if (vm.count("help")) {
-        std::cout << desc << std::endl;;
-        throw "";
-    }
-    try {
-        boost::program_options::notify(vm);
-    } catch (const boost::program_options::required_option& e) {
-        std::cout << desc << std::endl;;
-        throw "";
-    }
-
     // Create instance.
     InstanceBuilder instance_builder;
     instance_builder.read(
@@ -38,6 +20,10 @@ int main(int argc, char *argv[])
         parameters.guide_id = vm["guide"].as<GuideId>();
     if (vm.count("bidirectional"))
         parameters.bidirectional = vm["bidirectional"].as<bool>();
+    if (vm.count("bound"))
+        parameters.bound_id = vm["bound"].as<BoundId>();
+    if (vm.count("dominance"))
+        parameters.dominance = vm["dominance"].as<bool>();
     BranchingSchemeBidirectional branching_scheme(instance, parameters);
 
     // Run algorithm.
@@ -47,11 +33,18 @@ int main(int argc, char *argv[])
         run_greedy(branching_scheme, vm):
         (algorithm == "best-first-search")?
         run_best_first_search(branching_scheme, vm):
+        (algorithm == "best-first-search-2")?
+        run_best_first_search_2(branching_scheme, vm):
         (algorithm == "iterative-beam-search")?
         run_iterative_beam_search(branching_scheme, vm):
+        (algorithm == "iterative-beam-search-2")?
+        run_iterative_beam_search_2(branching_scheme, vm):
         (algorithm == "anytime-column-search")?
         run_anytime_column_search(branching_scheme, vm):
-        run_iterative_memory_bounded_best_first_search(branching_scheme, vm);
+        (algorithm == "iterative-memory-bounded-best-first-search")?
+        run_iterative_memory_bounded_best_first_search(branching_scheme, vm):
+        throw std::invalid_argument(
+                "Unknown algorithm \"" + algorithm + "\".");
 
     // Run checker.
     if (vm["print-checker"].as<int>() > 0
@@ -65,6 +58,40 @@ int main(int argc, char *argv[])
                 vm["print-checker"].as<int>());
     }
 
-    return 0;
+    return output.json["Output"];
 }
 
+int main(int argc, char *argv[])
+{
+    // Setup options.
+    boost::program_options::options_description desc = setup_args();
+    desc.add_options()
+        ("bidirectional,b", boost::program_options::value<bool>(), "")
+        ("guide,g", boost::program_options::value<GuideId>(), "")
+        ("bound", boost::program_options::value<BoundId>(), "set bound (0: one-machine, 1: two-machine on consecutive machines, 2: two-machine on all machine pairs)")
+        ("dominance", boost::program_options::value<bool>(), "enable dominance")
+        ;
+    boost::program_options::variables_map vm;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    try {
+        boost::program_options::notify(vm);
+    } catch (const boost::program_options::required_option& e) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    if (!vm.count("input") && !vm.count("batch")) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    check_algorithm(vm);
+
+    if (vm.count("batch"))
+        return run_batch(vm, solve);
+    solve(vm);
+
+    return 0;
+}
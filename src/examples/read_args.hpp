@@ -1,31 +1,73 @@
 #include "treesearchsolver/greedy.hpp"
 #include "treesearchsolver/best_first_search.hpp"
+#include "treesearchsolver/best_first_search_2.hpp"
 #include "treesearchsolver/iterative_beam_search.hpp"
 #include "treesearchsolver/iterative_beam_search_2.hpp"
 #include "treesearchsolver/iterative_memory_bounded_best_first_search.hpp"
 #include "treesearchsolver/anytime_column_search.hpp"
+#include "treesearchsolver/coalescing_writer.hpp"
 
+#include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace treesearchsolver
 {
 
-boost::program_options::options_description setup_args()
+/**
+ * Names of the algorithms which can be selected with --algorithm.
+ */
+const std::vector<std::string> algorithm_names = {
+    "greedy",
+    "best-first-search",
+    "best-first-search-2",
+    "iterative-beam-search",
+    "iterative-beam-search-2",
+    "iterative-memory-bounded-best-first-search",
+    "anytime-column-search"};
+
+boost::program_options::options_description setup_args(
+        const std::string& default_algorithm = "iterative-beam-search")
 {
     boost::program_options::options_description desc("Allowed options");
     desc.add_options()
         ("help,h", "produce help message")
-        ("input,i", boost::program_options::value<std::string>()->required(), "set input path (required)")
+        ("input,i", boost::program_options::value<std::string>(), "set input path (required unless --batch)")
         ("output,o", boost::program_options::value<std::string>()->default_value(""), "set JSON output path")
         ("certificate,c", boost::program_options::value<std::string>()->default_value(""), "set certificate path")
         ("format,f", boost::program_options::value<std::string>()->default_value(""), "set input file format (default: orlibrary)")
-        ("algorithm,a", boost::program_options::value<std::string>()->default_value("iterative-beam-search"), "set algorithm")
+        ("algorithm,a", boost::program_options::value<std::string>()->default_value(default_algorithm), "set algorithm (greedy, best-first-search, best-first-search-2, iterative-beam-search, iterative-beam-search-2, iterative-memory-bounded-best-first-search, anytime-column-search)")
         ("time-limit,t", boost::program_options::value<double>(), "set time limit in seconds\n  ex: 3600")
+        ("deadline-check-period", boost::program_options::value<double>(), "set the period between two checks of the timer in milliseconds (default: 100)")
         ("verbosity-level,v", boost::program_options::value<int>(), "set verbosity level")
         ("only-write-at-the-end,e", "only write output and certificate files at the end")
         ("log,l", boost::program_options::value<std::string>(), "set log file")
         ("log-to-stderr", "write log to stderr")
+        ("trace", boost::program_options::value<std::string>(), "set Chrome trace-event output path")
+        ("events", boost::program_options::value<std::string>(), "set JSON Lines events output path; the JSON output is then only written at the end")
+        ("history-statistics", "collect statistics on the history")
+        ("reference-value", boost::program_options::value<double>(), "set the reference value of the anytime profile")
+        ("target-gap", boost::program_options::value<double>(), "set the target primal gap of the anytime profile\n  ex: 0.01")
+        ("telemetry", boost::program_options::value<std::string>(), "set telemetry output path")
+        ("telemetry-format", boost::program_options::value<TelemetryFormat>(), "set telemetry format (prometheus, jsonl)")
+        ("telemetry-period", boost::program_options::value<double>(), "set telemetry period in milliseconds")
         ("print-checker", boost::program_options::value<int>()->default_value(1), "print checker")
+        ("batch", boost::program_options::value<std::string>(), "solve the instances of a list file (one path per line) or of a directory")
+        ("batch-output", boost::program_options::value<std::string>()->default_value(""), "set the JSON Lines output path of the batch (default: standard output)")
+        ("batch-time-limit", boost::program_options::value<double>(), "set the time limit of the whole batch in seconds, split across the instances")
+        ("number-of-threads", boost::program_options::value<int>()->default_value(1), "set the number of instances solved concurrently in batch mode")
 
         ("maximum-number-of-nodes", boost::program_options::value<int>(), "set the maximum number of nodes")
         ("growth-factor", boost::program_options::value<double>(), "set the growth factor")
@@ -37,44 +79,254 @@ boost::program_options::options_description setup_args()
     return desc;
 }
 
+/**
+ * Throw if the algorithm given with --algorithm is unknown.
+ *
+ * Called before reading any instance, so that a batch doesn't fail on each
+ * of its instances.
+ */
+void check_algorithm(
+        const boost::program_options::variables_map& vm)
+{
+    std::string algorithm = vm["algorithm"].as<std::string>();
+    if (std::find(
+                algorithm_names.begin(),
+                algorithm_names.end(),
+                algorithm) == algorithm_names.end()) {
+        throw std::invalid_argument(
+                "Unknown algorithm \"" + algorithm + "\".");
+    }
+}
+
+/**
+ * Intermediary JSON output written by a background thread.
+ *
+ * The search thread only serializes the new intermediary outputs and the
+ * background thread appends them to its own text, so that no thread copies
+ * or serializes the whole output at each improvement.
+ */
+class IntermediaryJsonOutput
+{
+
+public:
+
+    /**
+     * Serialize the intermediary outputs added since the previous call.
+     *
+     * Called by the search thread.
+     */
+    void add(const nlohmann::json& json)
+    {
+        auto it = json.find("IntermediaryOutputs");
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (parameters_.empty() && json.find("Parameters") != json.end())
+            parameters_ = json.at("Parameters").dump();
+        if (it == json.end())
+            return;
+        for (; number_of_intermediary_outputs_ < it->size();
+                ++number_of_intermediary_outputs_) {
+            new_intermediary_outputs_.push_back(
+                    (*it)[number_of_intermediary_outputs_].dump());
+        }
+    }
+
+    /**
+     * Write the JSON output.
+     *
+     * Called by the background thread.
+     */
+    void write(const std::string& json_output_path)
+    {
+        std::vector<std::string> new_intermediary_outputs;
+        std::string parameters;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            new_intermediary_outputs.swap(new_intermediary_outputs_);
+            parameters = parameters_;
+        }
+        for (const std::string& intermediary_output: new_intermediary_outputs) {
+            if (!intermediary_outputs_.empty())
+                intermediary_outputs_ += ",";
+            intermediary_outputs_ += intermediary_output;
+        }
+        write_atomically(
+                json_output_path,
+                [this, &parameters](const std::string& path)
+                {
+                    std::ofstream file(path);
+                    if (!file.good()) {
+                        throw std::runtime_error(
+                                "Unable to open file \"" + path + "\".");
+                    }
+                    file << "{\"IntermediaryOutputs\":[" << intermediary_outputs_ << "]";
+                    if (!parameters.empty())
+                        file << ",\"Parameters\":" << parameters;
+                    file << "}" << std::endl;
+                });
+    }
+
+private:
+
+    /** Mutex. */
+    std::mutex mutex_;
+
+    /** Serialized parameters. */
+    std::string parameters_;
+
+    /** Number of intermediary outputs serialized by the search thread. */
+    std::size_t number_of_intermediary_outputs_ = 0;
+
+    /** Intermediary outputs not yet taken by the background thread. */
+    std::vector<std::string> new_intermediary_outputs_;
+
+    /**
+     * Intermediary outputs taken by the background thread, separated by
+     * commas; only accessed by the background thread.
+     */
+    std::string intermediary_outputs_;
+
+};
+
+/**
+ * Serialize the certificate of the best solution of an output.
+ *
+ * Returns 'nullptr' if there is no certificate to write. If the branching
+ * scheme can't write its certificates in a stream, the certificate is written
+ * synchronously instead.
+ */
+template <typename BranchingScheme>
+std::shared_ptr<const std::string> serialize_certificate(
+        const Output<BranchingScheme>& output,
+        const std::string& certificate_path)
+{
+    if (certificate_path.empty())
+        return nullptr;
+    const BranchingScheme& branching_scheme = output.solution_pool.branching_scheme();
+    const std::shared_ptr<typename BranchingScheme::Node>& solution = output.solution_pool.best();
+    std::stringstream ss;
+    if (solution_write(branching_scheme, solution, ss))
+        return std::shared_ptr<const std::string>(new std::string(ss.str()));
+    write_atomically(
+            certificate_path,
+            [&branching_scheme, &solution](const std::string& path)
+            {
+                solution_write(branching_scheme, solution, path);
+            });
+    return nullptr;
+}
+
+/**
+ * Read the common parameters.
+ *
+ * Unless only writing at the end, returns the writer of the intermediary
+ * outputs and certificates, which must be stopped before writing the final
+ * ones.
+ */
 template <typename BranchingScheme>
-void read_args(
+std::shared_ptr<CoalescingWriter> read_args(
         Parameters<BranchingScheme>& parameters,
         const boost::program_options::variables_map& vm)
 {
-    parameters.timer.set_sigint_handler();
+    // In batch mode, the SIGINT handler is installed once by 'run_batch',
+    // since the instances are read concurrently.
+    if (!vm.count("batch"))
+        set_sigint_handler();
     parameters.messages_to_stdout = true;
     if (vm.count("time-limit"))
         parameters.timer.set_time_limit(vm["time-limit"].as<double>());
+    if (vm.count("deadline-check-period")) {
+        parameters.deadline_check_period = vm["deadline-check-period"].as<double>();
+        if (!(parameters.deadline_check_period > 0)) {
+            throw std::invalid_argument(
+                    "The deadline check period must be positive.");
+        }
+    }
     if (vm.count("verbosity-level"))
         parameters.verbosity_level = vm["verbosity-level"].as<int>();
     if (vm.count("log"))
         parameters.log_path = vm["log"].as<std::string>();
     parameters.log_to_stderr = vm.count("log-to-stderr");
+    if (vm.count("trace"))
+        parameters.trace_path = vm["trace"].as<std::string>();
+    if (vm.count("events"))
+        parameters.events_path = vm["events"].as<std::string>();
+    if (vm.count("history-statistics"))
+        parameters.history_statistics = true;
+    if (vm.count("reference-value"))
+        parameters.reference_value = vm["reference-value"].as<double>();
+    if (vm.count("target-gap"))
+        parameters.target_gap = vm["target-gap"].as<double>();
+    if (vm.count("telemetry"))
+        parameters.telemetry_path = vm["telemetry"].as<std::string>();
+    if (vm.count("telemetry-format"))
+        parameters.telemetry_format = vm["telemetry-format"].as<TelemetryFormat>();
+    if (vm.count("telemetry-period"))
+        parameters.telemetry_period = vm["telemetry-period"].as<double>();
     bool only_write_at_the_end = vm.count("only-write-at-the-end");
-    if (!only_write_at_the_end) {
-        std::string certificate_path = vm["certificate"].as<std::string>();
-        std::string json_output_path = vm["output"].as<std::string>();
-        parameters.new_solution_callback = [
-            json_output_path,
-            certificate_path](
-                    const Output<BranchingScheme>& output)
+    if (only_write_at_the_end)
+        return nullptr;
+
+    // Intermediary outputs and certificates are serialized by the search
+    // thread and written by a background thread, so that the search doesn't
+    // wait for file I/O and the background thread never reads the nodes,
+    // which the search may still modify.
+    std::shared_ptr<CoalescingWriter> writer(new CoalescingWriter());
+    std::string certificate_path = vm["certificate"].as<std::string>();
+    std::string json_output_path = vm["output"].as<std::string>();
+    // The intermediary outputs are streamed to the events file, if any;
+    // otherwise they are written in the JSON output.
+    std::shared_ptr<IntermediaryJsonOutput> intermediary_json_output(
+            (vm.count("events") || json_output_path.empty())?
+            nullptr: new IntermediaryJsonOutput());
+    parameters.new_solution_callback = [
+        writer,
+        json_output_path,
+        certificate_path,
+        intermediary_json_output](
+                const Output<BranchingScheme>& output)
+    {
+        std::shared_ptr<const std::string> certificate
+            = serialize_certificate(output, certificate_path);
+        if (intermediary_json_output != nullptr)
+            intermediary_json_output->add(output.json);
+        writer->submit([
+                json_output_path,
+                certificate_path,
+                intermediary_json_output,
+                certificate]()
         {
-            output.write_json_output(json_output_path);
-            solution_write(
-                    output.solution_pool.branching_scheme(),
-                    output.solution_pool.best(),
-                    certificate_path);
-        };
-    }
+            if (intermediary_json_output != nullptr)
+                intermediary_json_output->write(json_output_path);
+            if (certificate != nullptr) {
+                write_atomically(
+                        certificate_path,
+                        [&certificate](const std::string& path)
+                        {
+                            std::ofstream file(path);
+                            if (!file.good()) {
+                                throw std::runtime_error(
+                                        "Unable to open file \"" + path + "\".");
+                            }
+                            file << *certificate;
+                        });
+            }
+        });
+    };
+    return writer;
 }
 
 template <typename BranchingScheme>
 void write_output(
         const BranchingScheme& branching_scheme,
         const boost::program_options::variables_map& vm,
-        const Output<BranchingScheme>& output)
+        const Output<BranchingScheme>& output,
+        const std::shared_ptr<CoalescingWriter>& writer = nullptr)
 {
+    // Flush the intermediary outputs so that they don't overwrite the final
+    // ones.
+    if (writer != nullptr)
+        writer->stop();
+
     // Write solution.
     if (vm.count("certificate")) {
         solution_write(
@@ -93,9 +345,9 @@ const Output<BranchingScheme> run_greedy(
         const boost::program_options::variables_map& vm)
 {
     Parameters<BranchingScheme> parameters;
-    read_args(parameters, vm);
+    std::shared_ptr<CoalescingWriter> writer = read_args(parameters, vm);
     const Output<BranchingScheme> output = greedy(branching_scheme, parameters);
-    write_output(branching_scheme, vm, output);
+    write_output(branching_scheme, vm, output, writer);
     return output;
 }
 
@@ -105,11 +357,25 @@ const Output<BranchingScheme> run_best_first_search(
         const boost::program_options::variables_map& vm)
 {
     BestFirstSearchParameters<BranchingScheme> parameters;
-    read_args(parameters, vm);
+    std::shared_ptr<CoalescingWriter> writer = read_args(parameters, vm);
     if (vm.count("maximum-number-of-nodes"))
         parameters.maximum_number_of_nodes = vm["maximum-number-of-nodes"].as<int>();
     const Output<BranchingScheme> output = best_first_search(branching_scheme, parameters);
-    write_output(branching_scheme, vm, output);
+    write_output(branching_scheme, vm, output, writer);
+    return output;
+}
+
+template <typename BranchingScheme>
+const Output<BranchingScheme> run_best_first_search_2(
+        const BranchingScheme& branching_scheme,
+        const boost::program_options::variables_map& vm)
+{
+    BestFirstSearch2Parameters<BranchingScheme> parameters;
+    std::shared_ptr<CoalescingWriter> writer = read_args(parameters, vm);
+    if (vm.count("maximum-number-of-nodes"))
+        parameters.maximum_number_of_nodes = vm["maximum-number-of-nodes"].as<int>();
+    const Output<BranchingScheme> output = best_first_search_2(branching_scheme, parameters);
+    write_output(branching_scheme, vm, output, writer);
     return output;
 }
 
@@ -119,7 +385,7 @@ const Output<BranchingScheme> run_iterative_beam_search(
         const boost::program_options::variables_map& vm)
 {
     IterativeBeamSearchParameters<BranchingScheme> parameters;
-    read_args(parameters, vm);
+    std::shared_ptr<CoalescingWriter> writer = read_args(parameters, vm);
     if (vm.count("growth-factor"))
         parameters.growth_factor = vm["growth-factor"].as<double>();
     if (vm.count("minimum-size-of-the-queue"))
@@ -129,7 +395,7 @@ const Output<BranchingScheme> run_iterative_beam_search(
     if (vm.count("maximum-number-of-nodes"))
         parameters.maximum_number_of_nodes = vm["maximum-number-of-nodes"].as<int>();
     const Output<BranchingScheme> output = iterative_beam_search(branching_scheme, parameters);
-    write_output(branching_scheme, vm, output);
+    write_output(branching_scheme, vm, output, writer);
     return output;
 }
 
@@ -139,7 +405,7 @@ const Output<BranchingScheme> run_iterative_beam_search_2(
         const boost::program_options::variables_map& vm)
 {
     IterativeBeamSearch2Parameters<BranchingScheme> parameters;
-    read_args(parameters, vm);
+    std::shared_ptr<CoalescingWriter> writer = read_args(parameters, vm);
     if (vm.count("growth-factor"))
         parameters.growth_factor = vm["growth-factor"].as<double>();
     if (vm.count("minimum-size-of-the-queue"))
@@ -149,7 +415,7 @@ const Output<BranchingScheme> run_iterative_beam_search_2(
     if (vm.count("maximum-number-of-nodes"))
         parameters.maximum_number_of_nodes_expanded = vm["maximum-number-of-nodes"].as<int>();
     const Output<BranchingScheme> output = iterative_beam_search_2(branching_scheme, parameters);
-    write_output(branching_scheme, vm, output);
+    write_output(branching_scheme, vm, output, writer);
     return output;
 }
 
@@ -159,7 +425,7 @@ const Output<BranchingScheme> run_iterative_memory_bounded_best_first_search(
         const boost::program_options::variables_map& vm)
 {
     IterativeMemoryBoundedBestFirstSearchParameters<BranchingScheme> parameters;
-    read_args(parameters, vm);
+    std::shared_ptr<CoalescingWriter> writer = read_args(parameters, vm);
     if (vm.count("growth-factor"))
         parameters.growth_factor = vm["growth-factor"].as<double>();
     if (vm.count("minimum-size-of-the-queue"))
@@ -169,7 +435,7 @@ const Output<BranchingScheme> run_iterative_memory_bounded_best_first_search(
     if (vm.count("maximum-number-of-nodes"))
         parameters.maximum_number_of_nodes = vm["maximum-number-of-nodes"].as<int>();
     const Output<BranchingScheme> output = iterative_memory_bounded_best_first_search(branching_scheme, parameters);
-    write_output(branching_scheme, vm, output);
+    write_output(branching_scheme, vm, output, writer);
     return output;
 }
 
@@ -179,8 +445,9 @@ const Output<BranchingScheme> run_anytime_column_search(
         const boost::program_options::variables_map& vm)
 {
     AnytimeColumnSearchParameters<BranchingScheme> parameters;
-    read_args(parameters, vm);
-    parameters.initial_column_size = vm["initial-column-size"].as<int>();
+    std::shared_ptr<CoalescingWriter> writer = read_args(parameters, vm);
+    if (vm.count("initial-column-size"))
+        parameters.initial_column_size = vm["initial-column-size"].as<int>();
     if (vm.count("growth-factor"))
         parameters.column_size_growth_factor = vm["growth-factor"].as<double>();
     if (vm.count("maximum-number-of-nodes"))
@@ -188,8 +455,203 @@ const Output<BranchingScheme> run_anytime_column_search(
     if (vm.count("maximum-number-of-iterations"))
         parameters.maximum_number_of_iterations = vm["maximum-number-of-iterations"].as<int>();
     const Output<BranchingScheme> output = anytime_column_search(branching_scheme, parameters);
-    write_output(branching_scheme, vm, output);
+    write_output(branching_scheme, vm, output, writer);
     return output;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////// Batch mode //////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/** Function solving the instance of a variables map and returning its output. */
+using SolveFunction = std::function<nlohmann::json(const boost::program_options::variables_map&)>;
+
+/**
+ * Get the instances of a batch.
+ *
+ * If 'batch_path' is a directory, returns its regular files sorted by name;
+ * otherwise, returns the lines of the file, skipping empty lines and lines
+ * starting with '#'.
+ */
+std::vector<std::string> read_batch_instances(
+        const std::string& batch_path)
+{
+    std::vector<std::string> instance_paths;
+    if (boost::filesystem::is_directory(batch_path)) {
+        for (boost::filesystem::directory_iterator it(batch_path);
+                it != boost::filesystem::directory_iterator();
+                ++it) {
+            if (boost::filesystem::is_regular_file(it->status()))
+                instance_paths.push_back(it->path().string());
+        }
+        std::sort(instance_paths.begin(), instance_paths.end());
+        return instance_paths;
+    }
+
+    std::ifstream file(batch_path);
+    if (!file.good()) {
+        throw std::runtime_error(
+                "Unable to open file \"" + batch_path + "\".");
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+        instance_paths.push_back(line);
+    }
+    return instance_paths;
+}
+
+/** Set the value of an option in a variables map. */
+template <typename T>
+void set_option(
+        boost::program_options::variables_map& vm,
+        const std::string& option,
+        const T& value)
+{
+    vm.erase(option);
+    vm.insert(std::make_pair(
+                option,
+                boost::program_options::variable_value(boost::any(value), false)));
+}
+
+/**
+ * Solve the instances of a batch on a pool of threads.
+ *
+ * Each instance is solved by 'solve' with its own copy of the variables map,
+ * and thus its own instance and branching scheme. Instances are solved
+ * silently and only write their output as one line of the JSON Lines output
+ * of the batch, in the order in which they finish.
+ *
+ * If a time limit for the whole batch is given, each instance gets, when it
+ * starts, an equal share of the remaining worker time, i.e. the remaining
+ * time times the number of threads, minus the time still committed to the
+ * instances being solved, divided by the number of instances not started yet.
+ * The time left by the instances finishing early is thus shared among the
+ * instances starting afterwards.
+ */
+int run_batch(
+        const boost::program_options::variables_map& vm,
+        const SolveFunction& solve)
+{
+    std::vector<std::string> instance_paths = read_batch_instances(
+            vm["batch"].as<std::string>());
+    int64_t number_of_instances = instance_paths.size();
+    int number_of_threads = (std::max)(1, vm["number-of-threads"].as<int>());
+
+    std::ofstream batch_output_file;
+    std::string batch_output_path = vm["batch-output"].as<std::string>();
+    if (!batch_output_path.empty()) {
+        batch_output_file.open(batch_output_path);
+        if (!batch_output_file.good()) {
+            throw std::runtime_error(
+                    "Unable to open file \"" + batch_output_path + "\".");
+        }
+    }
+    std::ostream& batch_output = (batch_output_path.empty())?
+        std::cout: batch_output_file;
+
+    // Signal handlers are process-wide, so the SIGINT handler is installed
+    // once, before the workers start.
+    set_sigint_handler();
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<int64_t> next_instance_pos(0);
+    std::atomic<int64_t> number_of_failures(0);
+    std::mutex mutex;
+    // Deadlines, relative to 'start', of the instances being solved, and
+    // number of instances which already got their share of the time.
+    std::mutex deadlines_mutex;
+    std::map<int64_t, double> deadlines;
+    int64_t number_of_shared_instances = 0;
+
+    auto worker = [&]()
+    {
+        for (;;) {
+            int64_t instance_pos = next_instance_pos++;
+            if (instance_pos >= number_of_instances)
+                break;
+            const std::string& instance_path = instance_paths[instance_pos];
+
+            // Each instance is solved silently, its output only goes to the
+            // JSON Lines output.
+            boost::program_options::variables_map vm_instance = vm;
+            set_option(vm_instance, "input", instance_path);
+            set_option(vm_instance, "output", std::string(""));
+            set_option(vm_instance, "certificate", std::string(""));
+            set_option(vm_instance, "verbosity-level", 0);
+            set_option(vm_instance, "print-checker", 0);
+            set_option(vm_instance, "only-write-at-the-end", true);
+            vm_instance.erase("log");
+            vm_instance.erase("trace");
+            vm_instance.erase("events");
+            vm_instance.erase("telemetry");
+
+            // Time limit.
+            double time_limit = -1;
+            if (vm.count("batch-time-limit")) {
+                std::lock_guard<std::mutex> lock(deadlines_mutex);
+                double elapsed_time = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start).count();
+                double remaining_time = (std::max)(
+                        0.0,
+                        vm["batch-time-limit"].as<double>() - elapsed_time);
+                double committed_time = 0;
+                for (const auto& p: deadlines)
+                    committed_time += (std::max)(0.0, p.second - elapsed_time);
+                double available_time = (std::max)(
+                        0.0,
+                        remaining_time * number_of_threads - committed_time);
+                time_limit = (std::min)(
+                        remaining_time,
+                        available_time
+                        / (number_of_instances - number_of_shared_instances));
+                if (vm.count("time-limit"))
+                    time_limit = (std::min)(time_limit, vm["time-limit"].as<double>());
+                deadlines[instance_pos] = elapsed_time + time_limit;
+                number_of_shared_instances++;
+            } else if (vm.count("time-limit")) {
+                time_limit = vm["time-limit"].as<double>();
+            }
+            if (time_limit != -1)
+                set_option(vm_instance, "time-limit", time_limit);
+
+            nlohmann::json json = {
+                {"Instance", instance_path},
+                {"Position", instance_pos}};
+            if (time_limit != -1)
+                json["TimeLimit"] = time_limit;
+            auto instance_start = std::chrono::steady_clock::now();
+            try {
+                json["Output"] = solve(vm_instance);
+                json["Status"] = "ok";
+            } catch (const std::exception& e) {
+                json["Status"] = "error";
+                json["Error"] = e.what();
+                number_of_failures++;
+            }
+            json["WallTime"] = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - instance_start).count();
+            if (vm.count("batch-time-limit")) {
+                std::lock_guard<std::mutex> lock(deadlines_mutex);
+                deadlines.erase(instance_pos);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            batch_output << json.dump() << std::endl;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int thread_id = 1; thread_id < number_of_threads; ++thread_id)
+        threads.push_back(std::thread(worker));
+    worker();
+    for (std::thread& thread: threads)
+        thread.join();
+
+    return (number_of_failures > 0)? 1: 0;
+}
+
 }
@@ -4,32 +4,55 @@
 using namespace treesearchsolver;
 using namespace sequential_ordering;
 
-int main(int argc, char *argv[])
+nlohmann::json solve(
+        const boost::program_options::variables_map& vm)
 {
-    // Setup options.
-    boost::program_options::options_description desc = setup_args();
-    boost::program_options::variables_map vm;
-    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
-    if (vm.count("help")) {
-        std::cout << desc << std::endl;;
-        throw "";
-    }
-    try {
-        boost::program_options::notify(vm);
-    } catch (const boost::program_options::required_option& e) {
-        std::cout << desc << std::endl;;
-        throw "";
-    }
-
     // Create instance.
+    // If an instance cache is used, the parsed instance and the sorted
+    // neighbors are read from the cache if available, and written to it
+    // otherwise.
     InstanceBuilder instance_builder;
-    instance_builder.read(
-            vm["input"].as<std::string>(),
-            vm["format"].as<std::string>());
+    std::vector<LocationId> sorted_neighbors;
+    std::string cache_path;
+    bool cache_hit = false;
+    uint64_t hash = 0;
+    if (vm.count("instance-cache")) {
+        hash = instance_file_hash(
+                vm["input"].as<std::string>(),
+                vm["format"].as<std::string>());
+        cache_path = instance_cache_path(
+                vm["instance-cache"].as<std::string>(),
+                hash);
+        cache_hit = read_instance_cache(
+                cache_path,
+                hash,
+                instance_builder,
+                sorted_neighbors);
+    }
+    if (!cache_hit) {
+        instance_builder.read(
+                vm["input"].as<std::string>(),
+                vm["format"].as<std::string>());
+    }
     const Instance instance = instance_builder.build();
+    if (!cache_path.empty() && !cache_hit) {
+        sorted_neighbors = compute_sorted_neighbors(instance);
+        // The cache is only an optimization; the search goes on if it can't
+        // be written.
+        try {
+            write_instance_cache(cache_path, hash, instance, sorted_neighbors);
+        } catch (const std::exception& e) {
+            std::cerr << "Unable to write instance cache: " << e.what() << std::endl;
+        }
+    }
 
     // Create branching scheme.
-    BranchingScheme branching_scheme(instance);
+    BranchingScheme::Parameters parameters;
+    if (vm.count("candidates"))
+        parameters.maximum_number_of_candidates = vm["candidates"].as<LocationPos>();
+    if (vm.count("bound"))
+        parameters.bound_id = vm["bound"].as<BoundId>();
+    BranchingScheme branching_scheme(instance, parameters, sorted_neighbors);
 
     // Run algorithm.
     std::string algorithm = vm["algorithm"].as<std::string>();
@@ -38,11 +61,18 @@ int main(int argc, char *argv[])
         run_greedy(branching_scheme, vm):
         (algorithm == "best-first-search")?
         run_best_first_search(branching_scheme, vm):
+        (algorithm == "best-first-search-2")?
+        run_best_first_search_2(branching_scheme, vm):
         (algorithm == "iterative-beam-search")?
         run_iterative_beam_search(branching_scheme, vm):
+        (algorithm == "iterative-beam-search-2")?
+        run_iterative_beam_search_2(branching_scheme, vm):
         (algorithm == "anytime-column-search")?
         run_anytime_column_search(branching_scheme, vm):
-        run_iterative_memory_bounded_best_first_search(branching_scheme, vm);
+        (algorithm == "iterative-memory-bounded-best-first-search")?
+        run_iterative_memory_bounded_best_first_search(branching_scheme, vm):
+        throw std::invalid_argument(
+                "Unknown algorithm \"" + algorithm + "\".");
 
     // Run checker.
     if (vm["print-checker"].as<int>() > 0
@@ -56,6 +86,47 @@ int main(int argc, char *argv[])
                 vm["print-checker"].as<int>());
     }
 
-    return 0;
+    return output.json["Output"];
 }
 
+int main(int argc, char *argv[])
+{
+    // Setup options.
+    boost::program_options::options_description desc = setup_args();
+    desc.add_options()
+        ("instance-cache", boost::program_options::value<std::string>(), "set the directory of the binary instance cache")
+        ("candidates", boost::program_options::value<LocationPos>(), "set the maximum number of candidate successors of each location, at least 1 (default: -1, all)")
+        ("bound", boost::program_options::value<BoundId>(), "set bound (0: outgoing arcs, 1: feasible incoming and outgoing arcs)")
+        ;
+    boost::program_options::variables_map vm;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    try {
+        boost::program_options::notify(vm);
+    } catch (const boost::program_options::required_option& e) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    if (!vm.count("input") && !vm.count("batch")) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    check_algorithm(vm);
+    if (vm.count("candidates")) {
+        LocationPos maximum_number_of_candidates = vm["candidates"].as<LocationPos>();
+        if (maximum_number_of_candidates < 1
+                && maximum_number_of_candidates != -1) {
+            throw std::invalid_argument(
+                    "The number of candidates must be at least 1, or -1 for all.");
+        }
+    }
+
+    if (vm.count("batch"))
+        return run_batch(vm, solve);
+    solve(vm);
+
+    return 0;
+}
@@ -4,23 +4,34 @@
 using namespace treesearchsolver;
 using namespace simple_assembly_line_balancing_1;
 
-int main(int argc, char *argv[])
+template <typename BranchingScheme>
+const Output<BranchingScheme> run(
+        const BranchingScheme& branching_scheme,
+        const boost::program_options::variables_map& vm)
 {
-    // Setup options.
-    boost::program_options::options_description desc = setup_args();
-    boost::program_options::variables_map vm;
-    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
-    if (vm.count("help")) {
-        std::cout << desc << std::endl;;
-        throw "";
-    }
-    try {
-        boost::program_options::notify(vm);
-    } catch (const boost::program_options::required_option& e) {
-        std::cout << desc << std::endl;;
-        throw "";
-    }
+    std::string algorithm = vm["algorithm"].as<std::string>();
+    return
+        (algorithm == "greedy")?
+        run_greedy(branching_scheme, vm):
+        (algorithm == "best-first-search")?
+        run_best_first_search(branching_scheme, vm):
+        (algorithm == "best-first-search-2")?
+        run_best_first_search_2(branching_scheme, vm):
+        (algorithm == "iterative-beam-search")?
+        run_iterative_beam_search(branching_scheme, vm):
+        (algorithm == "iterative-beam-search-2")?
+        run_iterative_beam_search_2(branching_scheme, vm):
+        (algorithm == "anytime-column-search")?
+        run_anytime_column_search(branching_scheme, vm):
+        (algorithm == "iterative-memory-bounded-best-first-search")?
+        run_iterative_memory_bounded_best_first_search(branching_scheme, vm):
+        throw std::invalid_argument(
+                "Unknown algorithm \"" + algorithm + "\".");
+}
 
+nlohmann::json solve(
+        const boost::program_options::variables_map& vm)
+{
     // Create instance.
     InstanceBuilder instance_builder;
     instance_builder.read(
@@ -28,12 +39,37 @@ int main(int argc, char *argv[])
             vm["format"].as<std::string>());
     const Instance instance = instance_builder.build();
 
-    // Create branching scheme.
-    BranchingScheme branching_scheme(instance);
-
-    // Run algorithm.
-    std::string algorithm = vm["algorithm"].as<std::string>();
-    Output<BranchingScheme> output = run_iterative_beam_search_2(branching_scheme, vm);
+    // Create branching scheme and run algorithm.
+    std::string branching_scheme_name = vm["branching-scheme"].as<std::string>();
+    nlohmann::json output_json;
+    if (branching_scheme_name == "station") {
+        BranchingSchemeStation::Parameters parameters;
+        if (vm.count("direction"))
+            parameters.direction_id = vm["direction"].as<DirectionId>();
+        if (vm.count("jackson-dominance"))
+            parameters.jackson_dominance = vm["jackson-dominance"].as<bool>();
+        std::string algorithm = vm["algorithm"].as<std::string>();
+        if (vm.count("maximum-number-of-loads")) {
+            parameters.maximum_number_of_loads = vm["maximum-number-of-loads"].as<NodeId>();
+        } else if (algorithm != "best-first-search"
+                && algorithm != "best-first-search-2") {
+            // The number of loads of a station may be exponential in the
+            // number of jobs. Only the exact algorithms generate them all by
+            // default. The truncated expansions are reported in the
+            // "BranchingScheme" section of the output.
+            parameters.maximum_number_of_loads = 1000;
+        }
+        BranchingSchemeStation branching_scheme(instance, parameters);
+        Output<BranchingSchemeStation> output = run(branching_scheme, vm);
+        output_json = output.json["Output"];
+    } else if (branching_scheme_name == "job") {
+        BranchingScheme branching_scheme(instance);
+        Output<BranchingScheme> output = run(branching_scheme, vm);
+        output_json = output.json["Output"];
+    } else {
+        throw std::invalid_argument(
+                "Unknown branching scheme \"" + branching_scheme_name + "\".");
+    }
 
     // Run checker.
     if (vm["print-checker"].as<int>() > 0
@@ -47,5 +83,46 @@ int main(int argc, char *argv[])
                 vm["print-checker"].as<int>());
     }
 
+    return output_json;
+}
+
+int main(int argc, char *argv[])
+{
+    // Setup options.
+    boost::program_options::options_description desc = setup_args("iterative-beam-search-2");
+    desc.add_options()
+        ("branching-scheme", boost::program_options::value<std::string>()->default_value("job"), "set branching scheme (job, station)")
+        ("direction", boost::program_options::value<DirectionId>(), "set direction of the station branching scheme (0: forward, 1: backward, 2: automatic)")
+        ("jackson-dominance", boost::program_options::value<bool>(), "enable Jackson dominance in the station branching scheme")
+        ("maximum-number-of-loads", boost::program_options::value<NodeId>(), "set the maximum number of loads generated per node by the station branching scheme (default: all with the best-first searches, 1000 otherwise; the number of truncated expansions is written in the output)")
+        ;
+    boost::program_options::variables_map vm;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    try {
+        boost::program_options::notify(vm);
+    } catch (const boost::program_options::required_option& e) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    if (!vm.count("input") && !vm.count("batch")) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    check_algorithm(vm);
+    std::string branching_scheme_name = vm["branching-scheme"].as<std::string>();
+    if (branching_scheme_name != "job"
+            && branching_scheme_name != "station") {
+        throw std::invalid_argument(
+                "Unknown branching scheme \"" + branching_scheme_name + "\".");
+    }
+
+    if (vm.count("batch"))
+        return run_batch(vm, solve);
+    solve(vm);
+
     return 0;
 }
@@ -0,0 +1,182 @@
+#include "treesearchsolver/telemetry.hpp"
+
+#include "optimizationtools/utils/output.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+using namespace treesearchsolver;
+
+std::istream& treesearchsolver::operator>>(
+        std::istream& in,
+        TelemetryFormat& format)
+{
+    std::string token;
+    in >> token;
+    if (token == "prometheus") {
+        format = TelemetryFormat::Prometheus;
+    } else if (token == "jsonl"
+            || token == "json-lines") {
+        format = TelemetryFormat::JsonLines;
+    } else {
+        in.setstate(std::ios_base::failbit);
+    }
+    return in;
+}
+
+std::ostream& treesearchsolver::operator<<(
+        std::ostream& os,
+        TelemetryFormat format)
+{
+    switch (format) {
+    case TelemetryFormat::Prometheus: {
+        os << "prometheus";
+        break;
+    } case TelemetryFormat::JsonLines: {
+        os << "jsonl";
+        break;
+    }
+    }
+    return os;
+}
+
+TelemetryReporter::TelemetryReporter(
+        const std::string& algorithm_name,
+        const std::string& telemetry_path,
+        TelemetryFormat format,
+        double period,
+        int64_t node_size):
+    algorithm_name_(algorithm_name),
+    telemetry_path_(telemetry_path),
+    format_(format),
+    period_(period),
+    node_size_(node_size)
+{
+    counters_.number_of_nodes.store(0, std::memory_order_relaxed);
+    counters_.queue_size.store(0, std::memory_order_relaxed);
+    counters_.history_number_of_keys.store(0, std::memory_order_relaxed);
+    counters_.best_value.store(
+            std::numeric_limits<double>::quiet_NaN(),
+            std::memory_order_relaxed);
+}
+
+void TelemetryReporter::start()
+{
+    start_ = std::chrono::steady_clock::now();
+
+    // Truncate the file.
+    std::ofstream file(telemetry_path_);
+    if (!file.good()) {
+        throw std::runtime_error(
+                "Unable to open file \"" + telemetry_path_ + "\".");
+    }
+    file.close();
+
+    thread_ = std::thread([this]()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            condition_variable_.wait_for(
+                    lock,
+                    std::chrono::microseconds((int64_t)(period_ * 1000)));
+            if (stop_)
+                break;
+            write_snapshot();
+        }
+    });
+}
+
+void TelemetryReporter::stop()
+{
+    if (!thread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_variable_.notify_one();
+    thread_.join();
+    write_snapshot();
+}
+
+void TelemetryReporter::write_snapshot()
+{
+    double time = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start_).count();
+    int64_t number_of_nodes = counters_.number_of_nodes.load(std::memory_order_relaxed);
+    int64_t queue_size = counters_.queue_size.load(std::memory_order_relaxed);
+    int64_t history_number_of_keys = counters_.history_number_of_keys.load(std::memory_order_relaxed);
+    double best_value = counters_.best_value.load(std::memory_order_relaxed);
+    double nodes_per_second = (time > previous_time_)?
+        (number_of_nodes - previous_number_of_nodes_) / (time - previous_time_):
+        0.0;
+    // Rough proxy, neither a lower nor an upper bound: the nodes of the queue
+    // and one node per key of the history, without the memory allocated by
+    // the nodes themselves. The queued nodes which are also in the history
+    // are counted twice, and the nodes sharing a key with another node of
+    // the history are not counted.
+    int64_t estimated_memory = (queue_size + history_number_of_keys) * node_size_;
+    previous_time_ = time;
+    previous_number_of_nodes_ = number_of_nodes;
+
+    if (format_ == TelemetryFormat::JsonLines) {
+        std::ofstream file(telemetry_path_, std::ios_base::app);
+        nlohmann::json json = {
+            {"Algorithm", algorithm_name_},
+            {"Time", time},
+            {"NumberOfNodes", number_of_nodes},
+            {"NodesPerSecond", nodes_per_second},
+            {"QueueSize", queue_size},
+            {"HistoryNumberOfKeys", history_number_of_keys},
+            {"EstimatedMemory", estimated_memory},
+            {"BestValue", best_value}};
+        file << json << std::endl;
+        return;
+    }
+
+    // Write the snapshot in a temporary file and rename it, so that a scraper
+    // never reads a partial snapshot.
+    std::string tmp_path = telemetry_path_ + ".tmp";
+    {
+        std::ofstream file(tmp_path);
+        // Values such as the best value must not be rounded.
+        file << std::setprecision(std::numeric_limits<double>::max_digits10);
+        std::string labels = "{algorithm=\"" + algorithm_name_ + "\"}";
+        file
+            << "# HELP treesearchsolver_time_seconds Elapsed time.\n"
+            << "# TYPE treesearchsolver_time_seconds gauge\n"
+            << "treesearchsolver_time_seconds" << labels << " " << time << "\n"
+            << "# HELP treesearchsolver_nodes_total Number of nodes.\n"
+            << "# TYPE treesearchsolver_nodes_total counter\n"
+            << "treesearchsolver_nodes_total" << labels << " " << number_of_nodes << "\n"
+            << "# HELP treesearchsolver_nodes_per_second Number of nodes per second since the previous snapshot.\n"
+            << "# TYPE treesearchsolver_nodes_per_second gauge\n"
+            << "treesearchsolver_nodes_per_second" << labels << " " << nodes_per_second << "\n"
+            << "# HELP treesearchsolver_queue_size Size of the queue.\n"
+            << "# TYPE treesearchsolver_queue_size gauge\n"
+            << "treesearchsolver_queue_size" << labels << " " << queue_size << "\n"
+            << "# HELP treesearchsolver_history_keys Number of keys (distinct states) of the history.\n"
+            << "# TYPE treesearchsolver_history_keys gauge\n"
+            << "treesearchsolver_history_keys" << labels << " " << history_number_of_keys << "\n"
+            << "# HELP treesearchsolver_estimated_memory_bytes Rough proxy of the memory used by the queue and the history, counting one node per queued node and per history key.\n"
+            << "# TYPE treesearchsolver_estimated_memory_bytes gauge\n"
+            << "treesearchsolver_estimated_memory_bytes" << labels << " " << estimated_memory << "\n"
+            << "# HELP treesearchsolver_best_value Value of the best solution found.\n"
+            << "# TYPE treesearchsolver_best_value gauge\n"
+            << "treesearchsolver_best_value" << labels << " ";
+        if (std::isnan(best_value)) {
+            file << "NaN";
+        } else {
+            file << best_value;
+        }
+        file << "\n";
+    }
+#ifdef _WIN32
+    // 'rename' doesn't overwrite existing files on Windows.
+    std::remove(telemetry_path_.c_str());
+#endif
+    std::rename(tmp_path.c_str(), telemetry_path_.c_str());
+}
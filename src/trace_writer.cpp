@@ -0,0 +1,60 @@
+#include "treesearchsolver/trace_writer.hpp"
+
+using namespace treesearchsolver;
+
+void TraceWriter::begin(
+        const std::string& name,
+        double time,
+        const nlohmann::json& arguments)
+{
+    events_.push_back({'B', name, time * 1e6, arguments});
+    open_spans_.push_back(name);
+}
+
+void TraceWriter::end(
+        double time,
+        const nlohmann::json& arguments)
+{
+    if (open_spans_.empty())
+        return;
+    events_.push_back({'E', open_spans_.back(), time * 1e6, arguments});
+    open_spans_.pop_back();
+}
+
+void TraceWriter::instant(
+        const std::string& name,
+        double time,
+        const nlohmann::json& arguments)
+{
+    events_.push_back({'i', name, time * 1e6, arguments});
+}
+
+void TraceWriter::write() const
+{
+    if (trace_path_.empty())
+        return;
+    std::ofstream file(trace_path_);
+    if (!file.good()) {
+        throw std::runtime_error(
+                "Unable to open file \"" + trace_path_ + "\".");
+    }
+
+    nlohmann::json json_events = nlohmann::json::array();
+    for (const Event& event: events_) {
+        nlohmann::json json_event = {
+            {"name", event.name},
+            {"ph", std::string(1, event.phase)},
+            {"ts", event.timestamp},
+            {"pid", 1},
+            {"tid", 1},
+            {"args", event.arguments}};
+        // Instant events are scoped to the thread.
+        if (event.phase == 'i')
+            json_event["s"] = "t";
+        json_events.push_back(json_event);
+    }
+    nlohmann::json json = {
+        {"traceEvents", json_events},
+        {"displayTimeUnit", "ms"}};
+    file << json << std::endl;
+}